@@ -0,0 +1,514 @@
+/** --------------------------------------------------------
+* @file    menuBenchmark.cpp
+* @author  Luke Wagner
+* @version 1.0
+*
+* Menu benchmark suite
+*   Times the Menu operations that scale with the number of items, for menus of
+*	10 to 10,000 items, and prints the results as CSV or JSON. Frames are drawn to
+*	an offscreen render texture, so no window is opened and timings exclude buffer
+*	swaps. SFML still needs a display for its OpenGL context on Linux; to run
+*	headless, use Xvfb with Mesa's software renderer:
+*
+*	  LIBGL_ALWAYS_SOFTWARE=1 xvfb-run ./menuBenchmark --format json > results.json
+*
+* ------------------------------------------------------------ */
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "Menu.h"
+#include "geometry.h"
+#include "roundedRect.h"
+
+namespace {
+	// ======================================================
+	// Results
+	struct BenchResult {
+		std::string name;	//which operation was measured
+		std::size_t items;	//number of items in the menu
+		std::size_t iterations;	//how many times the operation ran
+		double totalMicroseconds;	//time for all iterations
+	};
+
+	// ------------------------------------------------------
+	/**
+	* Prints results as CSV, one row per benchmark and menu size
+	*/
+	void writeCsv(std::ostream& out, const std::vector<BenchResult>& results) {
+		out << "benchmark,items,iterations,total_us,per_iteration_ns\n";
+		for (const BenchResult& result : results) {
+			out << result.name << ',' << result.items << ',' << result.iterations << ','
+				<< result.totalMicroseconds << ',' << result.totalMicroseconds * 1000.0 / result.iterations << '\n';
+		}
+	}
+
+	// ------------------------------------------------------
+	/**
+	* Prints results as a JSON document: { "results": [ {...}, ... ] }
+	*/
+	void writeJson(std::ostream& out, const std::vector<BenchResult>& results) {
+		out << "{\n  \"results\": [\n";
+		for (std::size_t i = 0; i < results.size(); i++) {
+			const BenchResult& result = results[i];
+			out << "    { \"benchmark\": \"" << result.name << "\", \"items\": " << result.items
+				<< ", \"iterations\": " << result.iterations << ", \"total_us\": " << result.totalMicroseconds
+				<< ", \"per_iteration_ns\": " << result.totalMicroseconds * 1000.0 / result.iterations << " }"
+				<< (i + 1 < results.size() ? ",\n" : "\n");
+		}
+		out << "  ]\n}\n";
+	}
+
+	// ======================================================
+	// Helpers
+	/**
+	* Runs a function once and returns how long it took
+	*
+	*   @param fn - the code to time
+	*	@return double - elapsed time in microseconds
+	*/
+	template <typename Fn>
+	double timeMicroseconds(Fn&& fn) {
+		auto start = std::chrono::steady_clock::now();
+		fn();
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::micro>(end - start).count();
+	}
+
+	// ------------------------------------------------------
+	/**
+	* Label of the i-th benchmark item. Labels are unique and vary in width.
+	*/
+	std::string itemLabel(std::size_t i) {
+		return "Item " + std::to_string(i) + std::string(i % 7, 'W');
+	}
+
+	// ------------------------------------------------------
+	/**
+	* Adds items to a menu (untimed setup)
+	*/
+	std::vector<sf::Text*> populate(Menu& menu, sf::RenderTarget& target, std::size_t count) {
+		std::vector<sf::Text*> added;
+		added.reserve(count);
+		for (std::size_t i = 0; i < count; i++) {
+			added.push_back(menu.addMenuItem(target, itemLabel(i)));
+		}
+		return added;
+	}
+
+	// ------------------------------------------------------
+	/**
+	* Draws one complete frame containing the menu. sf::RenderTarget has no display(),
+	* so offscreen targets are finished here.
+	*/
+	void drawFrame(Menu& menu, sf::RenderTarget& target) {
+		target.clear();
+		menu.draw(target);
+		if (sf::RenderTexture* texture = dynamic_cast<sf::RenderTexture*>(&target)) {
+			texture->display();
+		}
+	}
+
+	// ======================================================
+	// Benchmarks
+	/**
+	* Runs every benchmark for one menu size and appends the results
+	*
+	*	@return false if a benchmark did not do the work it times
+	*/
+	bool runBenchmarks(sf::RenderTarget& target, std::size_t items, std::size_t frames, std::vector<BenchResult>& results) {
+		// addMenuItem, top docked (O(1) append) and bottom docked (moves previous items)
+		{
+			Menu menu;
+			double time = timeMicroseconds([&] { populate(menu, target, items); });
+			results.push_back({ "addMenuItem", items, items, time });
+		}
+		{
+			Menu menu;
+			menu.setDockingPosition(uiTools::BOTTOM_LEFT);
+			double time = timeMicroseconds([&] { populate(menu, target, items); });
+			results.push_back({ "addMenuItem_bottom", items, items, time });
+		}
+		{
+			// bulk insertion lays the menu out once
+			Menu menu;
+			menu.setDockingPosition(uiTools::BOTTOM_LEFT);
+			std::vector<std::string> labels;
+			for (std::size_t i = 0; i < items; i++) {
+				labels.push_back(itemLabel(i));
+			}
+			double time = timeMicroseconds([&] { menu.addMenuItems(target, std::move(labels)); });
+			results.push_back({ "addMenuItems_bottom", items, items, time });
+		}
+
+		// removeMenuItem in scattered order, plus the draw that lays out what is left
+		{
+			Menu menu;
+			std::vector<sf::Text*> added = populate(menu, target, items);
+			drawFrame(menu, target);
+			double time = timeMicroseconds([&] {
+				for (std::size_t stride = 0; stride < 2; stride++) {
+					for (std::size_t i = stride; i < added.size(); i += 2) {
+						menu.removeMenuItem(added[i]);
+					}
+				}
+				drawFrame(menu, target);
+			});
+			results.push_back({ "removeMenuItem", items, items, time });
+		}
+
+		// removeLastItem where every removal takes the widest item (bounds must shrink each time)
+		{
+			Menu menu;
+			for (std::size_t i = 0; i < items; i++) {
+				menu.addMenuItem(target, "Item " + std::string(i % 200, 'W'));
+			}
+			drawFrame(menu, target);
+			double time = timeMicroseconds([&] {
+				while (menu.removeLastItem()) {
+				}
+				drawFrame(menu, target);
+			});
+			results.push_back({ "removeLastItem_widest", items, items, time });
+		}
+
+		// removeFirstItem until empty
+		{
+			Menu menu;
+			populate(menu, target, items);
+			drawFrame(menu, target);
+			double time = timeMicroseconds([&] {
+				while (menu.removeFirstItem()) {
+				}
+				drawFrame(menu, target);
+			});
+			results.push_back({ "removeFirstItem", items, items, time });
+		}
+
+		// findMenuItem for every label
+		{
+			Menu menu;
+			populate(menu, target, items);
+			std::vector<std::string> labels;
+			for (std::size_t i = 0; i < items; i++) {
+				labels.push_back(itemLabel(i));
+			}
+			std::size_t found = 0;
+			double time = timeMicroseconds([&] {
+				for (const std::string& label : labels) {
+					if (menu.findMenuItem(label))
+						found++;
+				}
+			});
+			if (found != items) {
+				std::cerr << "findMenuItem found " << found << " of " << items << " items\n";
+			}
+			results.push_back({ "findMenuItem", items, items, time });
+		}
+
+		// setters that relayout existing items
+		{
+			Menu menu;
+			populate(menu, target, items);
+			const std::size_t iterations = 100;
+			double time = timeMicroseconds([&] {
+				for (std::size_t i = 0; i < iterations; i++) {
+					float padding = (i % 2 == 0) ? 30.f : 25.f;
+					menu.setPadding(padding, padding);
+				}
+			});
+			results.push_back({ "setPadding", items, iterations, time });
+		}
+		{
+			Menu menu;
+			populate(menu, target, items);
+			const std::size_t iterations = 100;
+			double time = timeMicroseconds([&] {
+				for (std::size_t i = 0; i < iterations; i++) {
+					menu.setComponentBuffer((i % 2 == 0) ? 12 : 10);
+				}
+			});
+			results.push_back({ "setComponentBuffer", items, iterations, time });
+		}
+
+		// sliding a cached menu moves one transform; the cache is not redrawn
+		{
+			Menu menu;
+			menu.setCachedRendering(true);
+			populate(menu, target, items);
+			drawFrame(menu, target);
+			double time = timeMicroseconds([&] {
+				for (std::size_t i = 0; i < frames; i++) {
+					menu.setOffset(sf::Vector2f(-static_cast<float>(i % 50) * 4, 0));
+					drawFrame(menu, target);
+				}
+			});
+			results.push_back({ "setOffset+draw_cached", items, frames, time });
+		}
+
+		// hit testing mouse moves that sweep down the target
+		{
+			Menu menu;
+			populate(menu, target, items);
+			drawFrame(menu, target);
+			const std::size_t iterations = 10000;
+			std::size_t hits = 0;
+			double time = timeMicroseconds([&] {
+				for (std::size_t i = 0; i < iterations; i++) {
+					sf::Event event;
+					event.type = sf::Event::MouseMoved;
+					event.mouseMove.x = 40;
+					event.mouseMove.y = static_cast<int>(i % target.getSize().y);
+					if (menu.handleEvent(event))
+						hits++;
+				}
+			});
+			if (hits == 0) {
+				std::cerr << "ERROR: handleEvent_mouseMoved hit no items\n";
+				return false;
+			}
+			results.push_back({ "handleEvent_mouseMoved", items, iterations, time });
+		}
+
+		// docking changes are applied (reformatted) by the next draw
+		{
+			Menu menu;
+			populate(menu, target, items);
+			drawFrame(menu, target);
+			const uiTools::cornerType corners[] = { uiTools::TOP_RIGHT, uiTools::BOTTOM_RIGHT, uiTools::BOTTOM_LEFT, uiTools::TOP_LEFT };
+			const std::size_t iterations = 20;
+			double time = timeMicroseconds([&] {
+				for (std::size_t i = 0; i < iterations; i++) {
+					menu.setDockingPosition(corners[i % 4]);
+					drawFrame(menu, target);
+				}
+			});
+			results.push_back({ "setDockingPosition+draw", items, iterations, time });
+		}
+
+		// steady-state frames in each render mode
+		for (int mode = 0; mode < 3; mode++) {
+			Menu menu;
+			menu.showComponentOutlines();
+			if (mode == 1)
+				menu.setBatchedRendering(true);
+			if (mode == 2)
+				menu.setCachedRendering(true);
+			populate(menu, target, items);
+			for (int i = 0; i < 5; i++) {
+				drawFrame(menu, target); // warm up glyph and outline caches
+			}
+			double time = timeMicroseconds([&] {
+				for (std::size_t i = 0; i < frames; i++) {
+					drawFrame(menu, target);
+				}
+			});
+			const char* names[] = { "draw", "draw_batched", "draw_cached" };
+			results.push_back({ names[mode], items, frames, time });
+		}
+
+		// items in six character sizes, from a glyph texture per size and from one distance field
+		// atlas; the font memory each needs is reported on stderr
+		for (int sdf = 0; sdf < 2; sdf++) {
+			const char* name = sdf ? "draw_sdf_sizes" : "draw_glyph_sizes";
+			Menu menu;
+			menu.setBatchedRendering(true);
+			if (sdf && !menu.setSdfText(true)) {
+				std::cerr << "shaders are not available; skipping " << name << "\n";
+				break;
+			}
+
+			const unsigned int sizes[] = { 12, 16, 20, 24, 32, 48 };
+			std::shared_ptr<sf::Font> font = FontRegistry::instance().getDefaultFont();
+			sf::Text textObj(menu.defaultTextObj);
+			textObj.setFont(*font);
+			for (std::size_t i = 0; i < items; i++) {
+				textObj.setCharacterSize(sizes[i % 6]);
+				menu.addMenuItem(target, itemLabel(i), &textObj);
+			}
+			for (int i = 0; i < 5; i++) {
+				drawFrame(menu, target); // warm up glyph caches
+			}
+			double time = timeMicroseconds([&] {
+				for (std::size_t i = 0; i < frames; i++) {
+					drawFrame(menu, target);
+				}
+			});
+			results.push_back({ name, items, frames, time });
+			std::cerr << name << ": " << menu.getStats().fontBytes / 1024 << " KB of fonts\n";
+		}
+
+		// scrolling a fixed height viewport; only the visible items are positioned and drawn
+		{
+			Menu menu;
+			menu.setViewportHeight(400);
+			populate(menu, target, items);
+			drawFrame(menu, target);
+			double time = timeMicroseconds([&] {
+				for (std::size_t i = 0; i < frames; i++) {
+					if (menu.getScrollOffset() >= menu.getMaxScrollOffset())
+						menu.setScrollOffset(0);
+					menu.scrollBy(37);
+					drawFrame(menu, target);
+				}
+			});
+			results.push_back({ "draw_scrolled", items, frames, time });
+		}
+
+		// 32 changing numbers per frame in a cached menu, as plain text items and as counter items
+		for (int counters = 0; counters < 2; counters++) {
+			Menu menu;
+			menu.setCachedRendering(true);
+			populate(menu, target, items);
+			std::vector<Menu::ItemHandle> handles;
+			for (int i = 0; i < 32; i++) {
+				if (counters)
+					handles.push_back(menu.addCounter(target, "Counter " + std::to_string(i) + ": ", 10000));
+				else
+					handles.push_back(menu.addItem(target, "Counter " + std::to_string(i) + ": 10000"));
+			}
+			drawFrame(menu, target);
+			double time = timeMicroseconds([&] {
+				for (std::size_t i = 0; i < frames; i++) {
+					for (std::size_t c = 0; c < handles.size(); c++) {
+						long long value = 10000 + static_cast<long long>(i * 7 + c);
+						if (counters)
+							menu.setCounterValue(handles[c], value);
+						else
+							menu.setItemText(handles[c], "Counter " + std::to_string(c) + ": " + std::to_string(value));
+					}
+					drawFrame(menu, target);
+				}
+			});
+			results.push_back({ counters ? "setCounterValue+draw_cached" : "setItemText+draw_cached", items, frames, time });
+		}
+
+		// one cached menu drawn to the full size target and to a quarter size offscreen texture each frame
+		{
+			sf::RenderTexture minimap;
+			if (minimap.create(320, 180)) {
+				Menu menu;
+				menu.setCachedRendering(true);
+				populate(menu, target, items);
+				drawFrame(menu, target);
+				sf::RenderStates minimapStates;
+				minimapStates.transform.scale(0.25f, 0.25f);
+				double time = timeMicroseconds([&] {
+					for (std::size_t i = 0; i < frames; i++) {
+						drawFrame(menu, target);
+						minimap.clear();
+						menu.draw(minimap, minimapStates);
+						minimap.display();
+					}
+				});
+				results.push_back({ "draw_cached_two_targets", items, frames, time });
+			} else {
+				std::cerr << "could not create the minimap texture; skipping draw_cached_two_targets\n";
+			}
+		}
+
+		// one outlined rounded rect per item: createRoundedRect() against the table-driven kernels
+		{
+			sf::Vector2f size(180, 30);
+			float checksum = 0;	//keeps the results alive
+			double time = timeMicroseconds([&] {
+				for (std::size_t i = 0; i < items; i++) {
+					sf::ConvexShape shape = createRoundedRect(size, sf::Color::Black, 2, sf::Color::White);
+					checksum += shape.getPoint(i % shape.getPointCount()).x;
+				}
+			});
+			results.push_back({ "createRoundedRect", items, items, time });
+
+			geometry::RoundedRectShape<> reusedShape;
+			reusedShape.setOutlineThickness(2);
+			time = timeMicroseconds([&] {
+				for (std::size_t i = 0; i < items; i++) {
+					reusedShape.setGeometry(size, 0.2f);
+					checksum += reusedShape.getPoint(i % reusedShape.getPointCount()).x;
+				}
+			});
+			results.push_back({ "RoundedRectShape_setGeometry", items, items, time });
+
+			// every rect goes into one buffer, as for a single batched draw call
+			std::vector<sf::Vertex> buffer(items * geometry::roundedRectVertexCount<5>(true));
+			time = timeMicroseconds([&] {
+				sf::Vertex* out = buffer.data();
+				for (std::size_t i = 0; i < items; i++) {
+					sf::Transform transform;
+					transform.translate(0, i * 40.f);
+					out += geometry::emitRoundedRect<5>(out, transform, size, sf::Color::Black, 2, sf::Color::White);
+				}
+				checksum += buffer.back().position.y;
+			});
+			results.push_back({ "emitRoundedRect", items, items, time });
+
+			if (checksum == -1) {
+				std::cerr << checksum;
+			}
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	std::string format = "csv";
+	std::string outputPath;
+	std::size_t maxItems = 10000;
+	std::size_t frames = 100;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--format" && i + 1 < argc) {
+			format = argv[++i];
+		} else if (arg == "--output" && i + 1 < argc) {
+			outputPath = argv[++i];
+		} else if (arg == "--max-items" && i + 1 < argc) {
+			maxItems = std::strtoul(argv[++i], nullptr, 10);
+		} else if (arg == "--frames" && i + 1 < argc) {
+			frames = std::strtoul(argv[++i], nullptr, 10);
+		} else {
+			std::cerr << "usage: menuBenchmark [--format csv|json] [--output file] [--max-items n] [--frames n]\n";
+			return 1;
+		}
+	}
+
+	// every case draws offscreen; no window is opened
+	sf::RenderTexture target;
+	if (!target.create(1280, 720)) {
+		std::cerr << "ERROR: could not create the render texture\n";
+		return 1;
+	}
+
+	// menus share the default font only while one of them holds it; keep it loaded for every case
+	std::shared_ptr<sf::Font> defaultFont = FontRegistry::instance().getDefaultFont();
+
+	std::vector<BenchResult> results;
+	for (std::size_t items = 10; items <= maxItems; items *= 10) {
+		std::cerr << "benchmarking " << items << " items\n";
+		if (!runBenchmarks(target, items, frames, results)) {
+			return 1;
+		}
+	}
+
+	std::ofstream file;
+	if (!outputPath.empty()) {
+		file.open(outputPath);
+		if (!file) {
+			std::cerr << "ERROR: could not open " << outputPath << "\n";
+			return 1;
+		}
+	}
+	std::ostream& out = outputPath.empty() ? std::cout : file;
+
+	if (format == "json")
+		writeJson(out, results);
+	else
+		writeCsv(out, results);
+
+	return 0;
+}
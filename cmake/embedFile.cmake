@@ -0,0 +1,8 @@
+# Writes a binary file as a C array header, like `xxd -i`.
+# Usage: cmake -DINPUT=<file> -DOUTPUT=<header> -DNAME=<array name> -P embedFile.cmake
+file(READ "${INPUT}" contents HEX)
+string(LENGTH "${contents}" hexLength)
+math(EXPR byteCount "${hexLength} / 2")
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${contents}")
+string(REGEX REPLACE "(0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],0x[0-9a-f][0-9a-f],)" "\\1\n" bytes "${bytes}")
+file(WRITE "${OUTPUT}" "unsigned char ${NAME}[] = {\n${bytes}\n};\nunsigned int ${NAME}_len = ${byteCount};\n")
@@ -9,44 +9,61 @@
 * ------------------------------------------------------------ */
 
 #include <iostream>
-#include "menu.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <set>
+#include <sstream>
+#include "Menu.h"
 #include "uiTools.h"
-#include "fonts.h"
-#include "roundedRect.h"
 
 Menu::Menu() {
 	initialized = false;
+	version = 0;
+	cacheDirty = true;
+	cacheValid = false;
+	cachedRendering = false;
+
+	// objects - must be empty before the setters below lay out the menu
+	numElements = 0;
+	mustReformatElements = false;
+	updateDepth = 0;
+	holeCount = 0;
+	firstItemIndex = 0;
+	visibleBegin = 0;
+	visibleEnd = 0;
+	layoutCount = 1;
+
+	// scrolling
+	viewportHeight = 0;
+	scrollOffset = 0;
 
 	// Set default values
 	setType(DYNAMIC);
 
 	// formatting
-	setDockingPosition(DEFAULT_DOCKING_POSITION);
+	dockingPosition = DEFAULT_DOCKING_POSITION;
 	textOriginPoint = DEFAULT_TEXT_ORIGIN_POINT;
+	paddingX = 0;
+	paddingY = 0;
+	componentBuffer = 0;
+	compOutlinePadding = 0;
 	setBounds(0, 0);
 	setPadding(DEFAULT_PADDING.x, DEFAULT_PADDING.y);
 	setComponentBuffer(DEFAULT_COMPONENT_BUFFER);
 	setCompOutlinePadding(DEFAULT_COMP_OUTLINE_PADDING);
-	numElements = 0;
-	mustReformatElements = false;
-
-	// objects
-	int len = sizeof(textObjs) / sizeof(textObjs[0]);
-	for (int i = 0; i < len; i++) {
-		textObjs[i] = NULL;
-	}
-
-	backupFontObj = new sf::Font;
-	fonts.insert(std::make_pair(BACKUP_FONT_NAME, backupFontObj));
-
-	if (!backupFontObj->loadFromMemory(fonts::arial, fonts::arial_len)) {
-		std::cout << "ERROR: Error loading default Menu font\n";
-	}
 
 	defaultTextObj.setCharacterSize(DEFAULT_CHAR_SIZE);
-	defaultTextObj.setFont(*backupFontObj);
+	statsOverlay.setCharacterSize(12);
+	statsOverlay.setFillColor(sf::Color::White);
+
+	// every menu shares one copy of the default font; the first menu has it parsed on a worker thread
+	setDefaultFont(FontRegistry::instance().loadDefaultFontAsync());
 
 	componentOutlineObj.setFillColor(sf::Color::Blue); // #check
+	cachedOutlineFillColor = componentOutlineObj.getFillColor();
+	cachedOutlineThickness = componentOutlineObj.getOutlineThickness();
+	cachedOutlineColor = componentOutlineObj.getOutlineColor();
 
 	background.setFillColor(sf::Color::Transparent);
 
@@ -54,10 +71,18 @@ Menu::Menu() {
 	outline.setOutlineThickness(1);
 	outline.setOutlineColor(sf::Color::White);
 
+	// input; hover and focus are shown by a translucent highlight behind the item
+	inputMapped = false;
+	inputFromWindow = false;
+	highlight.setFillColor(sf::Color(255, 255, 255, 48));
+
 	// miscellaneous
 	menuShown = true;
 	componentOutlinesShown = false;
 	menuBoundsShown = false;
+	statsOverlayShown = false;
+	batchedRendering = false;
+	sdfText = false;
 	setBackgroundColor(sf::Color::Transparent);
 
 	initialized = true;
@@ -65,6 +90,8 @@ Menu::Menu() {
 
 Menu::~Menu()
 {
+	// menu items are owned by itemPool, which destroys them along with the menu;
+	// fonts are freed by FontRegistry once the last menu using them is gone
 }
 
 bool Menu::setDockingPosition(uiTools::cornerType corner)
@@ -75,15 +102,19 @@ bool Menu::setDockingPosition(uiTools::cornerType corner)
 	}
 
 	dockingPosition = corner;
+	updateTransform(); // anchored to a different window corner
 
 	if (type == DYNAMIC) {
 		textOriginPoint = corner;
 	}
 
+	clearOutlineCache(); // outline origins depend on docking
+
 	if (numElements > 0) {
 		mustReformatElements = true; // reformat elements on the next draw call
 	}
 
+	markDirty();
 	return true;
 }
 
@@ -94,6 +125,8 @@ bool Menu::setTextOriginPoint(uiTools::cornerType corner)
 		return false;
 	} else {
 		textOriginPoint = corner;
+		clearOutlineCache();
+		markDirty();
 		return true;
 	}
 }
@@ -101,29 +134,36 @@ bool Menu::setTextOriginPoint(uiTools::cornerType corner)
 bool Menu::setPadding(float x, float y) {
 	// data validation
 	if (x >= 0 && y >= 0) {
-		float prevPaddingX = paddingX;
-		float prevPaddingY = paddingY;
+		float growX = (x - paddingX) * 2;
+		float growY = (y - paddingY) * 2;
 		paddingX = x;
 		paddingY = y;
 
-		float diffPaddingX = paddingX - prevPaddingX;
-		float diffPaddingY = paddingY - prevPaddingY;
-
-		if (type == DYNAMIC) {
-			setBounds(bounds.x + diffPaddingX * 2, bounds.y + diffPaddingY * 2);
-		}
-
-		if (numElements > 0) {
-			// reformat existing elements
-			applyPaddingDiff(diffPaddingX, diffPaddingY);
-		}
+		// items sit relative to the inner corner; moving it and resizing the menu is enough
+		updateTransform();
+		setBounds(bounds.x + growX, bounds.y + growY);
 
+		markDirty();
 		return true;
 	} else {
 		return false;
 	}
 }
 
+void Menu::setOffset(sf::Vector2f newOffset)
+{
+	if (newOffset != offset) {
+		offset = newOffset;
+		updateTransform();
+		version++; // the cache is still valid, but the menu moved
+	}
+}
+
+void Menu::move(sf::Vector2f delta)
+{
+	setOffset(offset + delta);
+}
+
 bool Menu::setComponentBuffer(int newVal)
 {
 	// data validation
@@ -132,9 +172,10 @@ bool Menu::setComponentBuffer(int newVal)
 		componentBuffer = newVal;
 
 		// move elements up/down
-		if (newVal != oldVal && numElements > 0)
-			applyCompBufferDiff(newVal - oldVal);
+		if (newVal != oldVal)
+			requestLayout();
 
+		markDirty();
 		return true;
 	} else
 		return false;
@@ -144,10 +185,21 @@ bool Menu::setCompOutlinePadding(float newVal)
 {
 	// data validation #check
 	compOutlinePadding = newVal;
+	clearOutlineCache();
+
+	// every item's outline padding changed; rebuild widths from the stored text widths
+	itemWidths.clear();
+	for (std::size_t i = firstItemIndex; i < textObjs.size(); i++) {
+		if (textObjs[i] != NULL) {
+			ItemSlot& slot = itemSlots[textObjSlots[i]];
+			slot.widthEntry = itemWidths.insert(slot.textWidth + slot.item->getCharacterSize() * compOutlinePadding / 2);
+		}
+	}
 
 	if (numElements > 0)
 		mustReformatElements = true; //#check
 
+	markDirty();
 	return true;
 }
 
@@ -155,26 +207,252 @@ void Menu::setBackgroundColor(sf::Color color)
 {
 	backgroundColor = color;
 	background.setFillColor(backgroundColor);
+	markDirty();
+}
+
+void Menu::setBatchedRendering(bool enabled)
+{
+	batchedRendering = enabled;
+	batchedCounters.clear(); // counters drawn meanwhile no longer match counterBatch
+}
+
+void Menu::setCachedRendering(bool enabled)
+{
+	cachedRendering = enabled;
+	markDirty();
+}
+
+bool Menu::setSdfText(bool enabled)
+{
+	// data validation
+	if (enabled && !SdfFont::getShader()) {
+		std::cout << "ERROR: shaders are not available; menu items keep their normal glyphs. (Menu::setSdfText())\n";
+		return false;
+	}
+	if (enabled == sdfText) {
+		return true;
+	}
+
+	sdfText = enabled;
+	if (!sdfText) {
+		sdfFonts.clear();
+		for (ItemSlot& slot : itemSlots) {
+			slot.atlasFont = nullptr;
+		}
+	}
+
+	// items are measured with the other glyphs now
+	for (std::uint32_t i = 0; i < itemSlots.size(); i++) {
+		if (itemSlots[i].item && !itemSlots[i].awaitingFont) {
+			untrackItemWidth(i);
+			trackItemWidth(i);
+		}
+	}
+	clearOutlineCache();
+	requestLayout();
+	markDirty();
+	return true;
+}
+
+void Menu::markDirty()
+{
+	cacheDirty = true;
+	version++;
+}
+
+bool Menu::setViewportHeight(float height)
+{
+	// data validation
+	if (height < 0) {
+		std::cout << "ERROR: viewport height must not be negative. (Menu::setViewportHeight())\n";
+		return false;
+	}
+
+	if (viewportHeight == height) {
+		return true;
+	}
+
+	viewportHeight = height;
+	setBounds(bounds.x, bounds.y); // resize the background to the viewport
+
+	if (numElements > 0) {
+		mustReformatElements = true; // items are placed up front without a viewport, lazily with one
+	}
+
+	markDirty();
+	return true;
+}
+
+bool Menu::setScrollOffset(float offset)
+{
+	offset = std::max(0.f, std::min(offset, getMaxScrollOffset()));
+	if (scrollOffset != offset) {
+		// items stay where they are; only the view over them moves
+		scrollOffset = offset;
+		markDirty();
+	}
+
+	return true;
+}
+
+void Menu::scrollBy(float delta)
+{
+	setScrollOffset(scrollOffset + delta);
+}
+
+void Menu::resetStats()
+{
+	stats = Stats();
+}
+
+Menu::Stats Menu::getStats() const
+{
+	Stats measured = stats;
+
+	// items: pool storage, the arrays indexing it and per item strings and glyph vertices
+	measured.itemBytes = itemPool.capacity() * sizeof(sf::Text) +
+		textObjs.capacity() * sizeof(sf::Text*) +
+		textObjSlots.capacity() * sizeof(std::uint32_t) +
+		itemOffsets.capacity() * sizeof(float) +
+		itemSlots.capacity() * sizeof(ItemSlot) +
+		freeSlots.capacity() * sizeof(std::uint32_t) +
+		labelIndex.bucket_count() * sizeof(void*) +
+		labelIndex.size() * (sizeof(std::pair<const std::size_t, std::uint32_t>) + sizeof(void*)) +
+		itemWidths.size() * (sizeof(float) + 4 * sizeof(void*)) +
+		textMetrics.getMemoryUsage();
+
+	std::set<std::pair<const sf::Font*, unsigned int>> glyphPages;	//font textures the items use
+	for (const ItemSlot& slot : itemSlots) {
+		if (slot.item) {
+			std::size_t characters = slot.item->getString().getSize();
+			measured.itemBytes += slot.label.capacity() + characters * (sizeof(sf::Uint32) + 6 * sizeof(sf::Vertex));
+			if (slot.counter)
+				measured.itemBytes += slot.counter->getMemoryUsage();
+			if (slot.counter || !sdfText)
+				glyphPages.insert({ slot.item->getFont(), slot.item->getCharacterSize() });
+		}
+	}
+
+	// fonts: the ones this menu holds, plus the glyph textures its items use in them
+	for (const std::shared_ptr<sf::Font>& font : fonts) {
+		measured.fontBytes += sizeof(sf::Font);
+		for (const auto& page : glyphPages) {
+			if (page.first == font.get()) {
+				sf::Vector2u textureSize = font->getTexture(page.second).getSize();
+				measured.fontBytes += static_cast<std::size_t>(textureSize.x) * textureSize.y * 4;
+			}
+		}
+	}
+	for (const auto& sdfFont : sdfFonts) {
+		measured.fontBytes += sdfFont.second.font->getMemoryUsage();
+	}
+
+	// cached geometry: component outlines, the render batch and the render cache texture
+	measured.geometryBytes = outlineCache.bucket_count() * sizeof(void*) + renderBatch.getMemoryUsage() + counterBatch.getMemoryUsage();
+	for (const auto& entry : outlineCache) {
+		std::size_t points = entry.second.shape.getPointCount();
+		measured.geometryBytes += sizeof(entry) + sizeof(void*) +
+			(points + 2 + (points + 1) * 2) * sizeof(sf::Vertex) + entry.second.string.getSize() * sizeof(sf::Uint32);
+	}
+	sf::Vector2u cacheSize = renderCache.getSize();
+	measured.geometryBytes += static_cast<std::size_t>(cacheSize.x) * cacheSize.y * 4;
+
+	return measured;
+}
+
+float Menu::getScrollOffset() const
+{
+	return scrollOffset;
+}
+
+float Menu::getMaxScrollOffset() const
+{
+	return std::max(0.f, bounds.y - background.getSize().y);
+}
+
+bool Menu::setDefaultFont(FontRegistry::FontFuture font)
+{
+	// data validation
+	if (!font.valid()) {
+		std::cout << "ERROR: no font to set. (Menu::setDefaultFont())\n";
+		return false;
+	}
+
+	pendingFont = font;
+	resolvePendingFont(); // applies it right away if it is already loaded
+	return true;
+}
+
+std::size_t Menu::prewarmGlyphs(const sf::String& characters, const std::vector<unsigned int>& characterSizes)
+{
+	if (pendingFont.valid()) {
+		pendingFont.wait();
+		resolvePendingFont();
+	}
+
+	const sf::Font* font = defaultTextObj.getFont();
+	if (!font) {
+		std::cout << "ERROR: no font to prewarm. (Menu::prewarmGlyphs())\n";
+		return 0;
+	}
+
+	std::vector<unsigned int> sizes = characterSizes;
+	if (sizes.empty()) {
+		sizes.push_back(defaultTextObj.getCharacterSize());
+	}
+
+	bool bold = (defaultTextObj.getStyle() & sf::Text::Bold) != 0;
+	if (SdfFont* sdfFont = getSdfFont(font)) {
+		// one atlas serves every size
+		std::size_t before = sdfFont->getMemoryUsage();
+		sdfFont->prepare(characters, bold);
+		return sdfFont->getMemoryUsage() - before;
+	}
+	return FontRegistry::prewarm(*font, characters, sizes, bold, defaultTextObj.getOutlineThickness());
+}
+
+bool Menu::isFontLoaded() const
+{
+	return !pendingFont.valid() || pendingFont.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+sf::Vector2f Menu::getOffset() const
+{
+	return offset;
+}
+
+sf::Transform Menu::getTransform() const
+{
+	return menuTransform * itemTransform;
+}
+
+unsigned long Menu::getVersion() const
+{
+	return version;
 }
 
 void Menu::showMenu()
 {
 	menuShown = true;
+	markDirty();
 }
 
 void Menu::hideMenu()
 {
 	menuShown = false;
+	markDirty();
 }
 
 void Menu::showMenuBounds()
 {
 	menuBoundsShown = true;
+	markDirty();
 }
 
 void Menu::hideMenuBounds()
 {
 	menuBoundsShown = false;
+	markDirty();
 }
 
 void Menu::toggleMenuBounds()
@@ -184,16 +462,19 @@ void Menu::toggleMenuBounds()
 	} else {
 		menuBoundsShown = true;
 	}
+	markDirty();
 }
 
 void Menu::showComponentOutlines()
 {
 	componentOutlinesShown = true;
+	markDirty();
 }
 
 void Menu::hideComponentOutlines()
 {
 	componentOutlinesShown = false;
+	markDirty();
 }
 
 void Menu::toggleComponentOutlines()
@@ -203,10 +484,27 @@ void Menu::toggleComponentOutlines()
 	} else {
 		componentOutlinesShown = true;
 	}
+	markDirty();
+}
+
+void Menu::showStatsOverlay()
+{
+	statsOverlayShown = true;
+}
+
+void Menu::hideStatsOverlay()
+{
+	statsOverlayShown = false;
+}
+
+void Menu::toggleStatsOverlay()
+{
+	statsOverlayShown = !statsOverlayShown;
 }
 
-sf::Text* Menu::addMenuItem(sf::RenderWindow& win, const std::string text, const sf::Text* textObj) {
+sf::Text* Menu::addMenuItem(sf::RenderTarget& target, const std::string text, const sf::Text* textObj) {
 	const sf::Text* objToUse = textObj ? textObj : &defaultTextObj; //uses textObj if provided, otherwise defaultTextObj
+	anchorTo(target.getSize());
 
 	int index = -1;
 	sf::Text* addedItem = addTextObj(*objToUse, index); // Add the new text object and store its index
@@ -214,8 +512,10 @@ sf::Text* Menu::addMenuItem(sf::RenderWindow& win, const std::string text, const
 	if (addedItem) {
 		// set added item properties
 		addedItem->setString(text);
+		indexLabel(textObjSlots[index], text);
+		itemSlots[textObjSlots[index]].awaitingFont = !textObj && pendingFont.valid(); // measured again when the font arrives
+		trackItemWidth(textObjSlots[index]);
 		int addedItemHeight = addedItem->getCharacterSize();
-		uiTools::setObjectOrigin(*addedItem, textOriginPoint);
 
 		// get last element added
 		sf::Text* lastElementAdded = nullptr;
@@ -223,444 +523,1556 @@ sf::Text* Menu::addMenuItem(sf::RenderWindow& win, const std::string text, const
 			lastElementAdded = textObjs[index - 1];
 		}
 
+		// offsets are rebuilt by the next layout if a removal left them out of step with textObjs
+		if (itemOffsets.size() == static_cast<std::size_t>(index)) {
+			if (lastElementAdded)
+				itemOffsets.push_back(itemOffsets.back() + lastElementAdded->getCharacterSize() + componentBuffer);
+			else
+				itemOffsets.push_back(0);
+		}
+
 		// set position of added item and/or move previous menu items based on lastElementAdded
-		if (dockingPosition == uiTools::TOP_LEFT || dockingPosition == uiTools::TOP_RIGHT) {
-			addedItem->setPosition(calculateTextObjPosition(lastElementAdded, win));
+		if (updateDepth > 0) {
+			// laid out once, by commitUpdate()
+			numElements++;
+			mustReformatElements = true;
+		} else if (viewportHeight > 0) {
+			// positioned when it scrolls into view; at the bottom, every previous item moves up
+			if (dockingPosition == uiTools::BOTTOM_LEFT || dockingPosition == uiTools::BOTTOM_RIGHT)
+				layoutCount++;
+			updateBounds(addedItemHeight);
+			numElements++;
+		} else if (dockingPosition == uiTools::TOP_LEFT || dockingPosition == uiTools::TOP_RIGHT) {
+			setItemOrigin(textObjSlots[index], textOriginPoint);
+			addedItem->setPosition(calculateTextObjPosition(lastElementAdded));
+			updateBounds(addedItemHeight); // update menu bounds
+			numElements++;
 		} else {
-			//using nullptr here means calculateTextObjPosition() will return the menu's inner corner
-			addedItem->setPosition(calculateTextObjPosition(nullptr, win));
-			movePreviousElements(index, win);
+			// added item takes the inner corner; every previous item moves up by one "space"
+			numElements++;
+			requestLayout();
 		}
 
-		updateBounds(addedItem, addedItemHeight); // update menu bounds
-
-		numElements++;
+		markDirty();
 		return addedItem;
 	} else {
-		std::cout << "ERROR: Not able to add menu item. Maximum elements already added.\n";
+		std::cout << "ERROR: Not able to add menu item.\n";
 		return nullptr;
 	}
 }
 
-sf::Text* Menu::findMenuItem(const std::string text)
+void Menu::beginUpdate()
 {
-	int len = sizeof(textObjs) / sizeof(textObjs[0]);
-	for (int i = 0; i < len; i++) {
-		if (textObjs[i] != NULL) {
-			// check object's string field
-			if (textObjs[i]->getString() == text) {
-				return textObjs[i];
-			}
-		} else {
-			break;
-		}
+	updateDepth++;
+}
+
+bool Menu::commitUpdate()
+{
+	if (updateDepth == 0) {
+		std::cout << "ERROR: commitUpdate() called without beginUpdate(). (Menu::commitUpdate())\n";
+		return false;
+	}
+
+	updateDepth--;
+	if (updateDepth == 0 && mustReformatElements && !pendingFont.valid()) {
+		layoutElements();
+		mustReformatElements = false;
+		markDirty();
+	}
+
+	return true;
+}
+
+sf::Text* Menu::findMenuItem(std::string_view text)
+{
+	std::uint32_t slotIndex = findLabel(text);
+	if (slotIndex < itemSlots.size()) {
+		return itemSlots[slotIndex].item;
 	}
 
 	return nullptr;
 }
 
+Menu::ItemHandle Menu::findItem(std::string_view text)
+{
+	std::uint32_t slotIndex = findLabel(text);
+	if (slotIndex < itemSlots.size()) {
+		return makeHandle(itemSlots[slotIndex].orderIndex);
+	}
+
+	return ItemHandle();
+}
+
 bool Menu::removeMenuItem(sf::Text* objToRemove)
 {
 	if (objToRemove == NULL) {
 		// trying to remove an object that may have already been deleted
 		return false;
 	}
-	
-	int len = sizeof(textObjs) / sizeof(textObjs[0]);
-	for (int i = 0; i < len; i++) {
-		if (textObjs[i] != NULL) {
-			if (textObjs[i] == objToRemove) {
-				// adjust other menu items' positions
-				if (dockingPosition == uiTools::TOP_RIGHT || dockingPosition == uiTools::TOP_LEFT) {
-					for (int j = i + 1; j < len; j++) {
-						if (textObjs[j] != NULL) {
-							sf::Vector2f currentPos = textObjs[j]->getPosition();
-							textObjs[j]->setPosition(currentPos.x, currentPos.y - textObjs[i]->getCharacterSize() - componentBuffer);
-						} else {
-							break;
-						}
-					}
-				} else {
-					for (int j = i - 1; j >= 0; j--) {
-						if (textObjs[j] != NULL) {
-							sf::Vector2f currentPos = textObjs[j]->getPosition();
-							textObjs[j]->setPosition(currentPos.x, currentPos.y + textObjs[i]->getCharacterSize() + componentBuffer);
-						} else {
-							break;
-						}
-					}
-				}
-
-				// change menu bounds
-				bool widest = false;
-				if (getWidestItemIndex() == i) {
-					// objToRemove is the widest item in the menu
-					widest = true;
-				}
-				if (numElements > 1) {
-					setBounds(bounds.x, bounds.y - objToRemove->getCharacterSize() - componentBuffer);
-				} else {
-					setBounds(paddingX * 2, paddingY * 2);
-				}
-
-				// delete object and reformat array
-				delete textObjs[i];
-				textObjs[i] = nullptr;
-				numElements--;
-				reformatArray(textObjs, len);
-
-				if (widest && textObjs[getWidestItemIndex()] != NULL) {
-					sf::Text* widestItemPostDeletion = textObjs[getWidestItemIndex()];
-					float newWidth = widestItemPostDeletion->getLocalBounds().width + widestItemPostDeletion->getCharacterSize() *
-						compOutlinePadding / 2 + paddingX * 2;
-					setBounds(newWidth, bounds.y);
-				}
-
-				return true;
-			}
-		} else {
-			return false;
-		}
+
+	auto found = std::find(textObjs.begin() + firstItemIndex, textObjs.end(), objToRemove);
+	if (found == textObjs.end()) {
+		return false;
 	}
+
+	return removeItem(makeHandle(found - textObjs.begin()));
 }
 
 bool Menu::removeLastItem()
 {
-	// find index of last item
-	int len = sizeof(textObjs) / sizeof(textObjs[0]);
-	int index = -1;
-	for (int i = 0; i < len; i++) {
-		if (textObjs[i] != NULL) {
-			index++;
-		} else {
-			break;
-		}
-	}
-
-	if (index < 0)
+	if (textObjs.empty())
 		return false;
 	else {
 		// remove item
-		sf::Text* objToRemove = textObjs[index];
-		removeMenuItem(objToRemove);
-		return true;
-	}	
+		return removeItem(makeHandle(getLastIndex()));
+	}
 }
 
 bool Menu::removeFirstItem()
 {
-	if (textObjs[0] != NULL) {
-		return removeMenuItem(textObjs[0]);
-		return true;
+	if (!textObjs.empty()) {
+		return removeItem(makeHandle(firstItemIndex));
 	} else {
 		return false;
 	}
 }
 
-void Menu::draw(sf::RenderWindow& win)
+Menu::ItemHandle Menu::addItem(sf::RenderTarget& target, const std::string text, const sf::Text* textObj)
 {
-	if (mustReformatElements) {
-		reformatElements(win); // #check
-		mustReformatElements = false;
+	if (addMenuItem(target, text, textObj)) {
+		return makeHandle(getLastIndex());
+	} else {
+		return ItemHandle();
 	}
+}
 
-	sf::Vector2f windowBounds = { static_cast<float>(win.getSize().x), static_cast<float>(win.getSize().y) };
-	if (background.getPosition() != uiTools::cornerTypeToVector(dockingPosition, windowBounds)) {
-		// dockingPosition has changed; must adjust bakground and outline positions
-		background.setPosition(uiTools::cornerTypeToVector(dockingPosition, windowBounds));
-		outline.setPosition(uiTools::cornerTypeToVector(dockingPosition, windowBounds));
-	}
+Menu::ItemHandle Menu::addCounter(sf::RenderTarget& target, const std::string& label, long long value, const sf::Text* textObj)
+{
+	std::unique_ptr<CounterText> counter(new CounterText());
+	counter->setValue(value);
 
-	// draw background
-	if (type == STATIC || numElements > 0)
-		win.draw(background);
+	// the item holds the layout string, which only changes with the number's length
+	ItemHandle handle = addItem(target, counter->getLayoutString(label), textObj);
+	if (!isValid(handle)) {
+		return handle;
+	}
 
-	// text objects
-	int len = sizeof(textObjs) / sizeof(textObjs[0]);
-	for (int i = 0; i < len; i++) {
-		if (textObjs[i] != NULL) {
-			// Reformat any elements that would be out of bounds
-			// check first
-			if (dockingPosition == uiTools::TOP_RIGHT || dockingPosition == uiTools::BOTTOM_RIGHT) {
-				sf::FloatRect localBounds = textObjs[i]->getLocalBounds();
-				if (localBounds.left + localBounds.width != textObjs[i]->getOrigin().x) {
-					// object's horizontal size has changed, must realigin in menu
-					// reset object origin
-					if (textOriginPoint == uiTools::TOP_RIGHT)
-						uiTools::setObjectOrigin(*textObjs[i], uiTools::TOP_RIGHT);
-					else
-						uiTools::setObjectOrigin(*textObjs[i], uiTools::BOTTOM_RIGHT);
-
-					sf::Vector2f outerCorner = uiTools::cornerTypeToVector(dockingPosition, { static_cast<float>(win.getSize().x), static_cast<float>(win.getSize().y) });
-					sf::Vector2f innerCorner = getInnerCorner(outerCorner);
-					textObjs[i]->setPosition(innerCorner.x, textObjs[i]->getPosition().y);
-				}
-			}
+	unindexLabel(handle.index);
+	indexLabel(handle.index, label);
+	itemSlots[handle.index].counter = std::move(counter);
+	counterSlots.push_back(handle.index);
+	if (sdfText) {
+		markItemDirty(handle); // was measured with the atlas' glyphs; counters are drawn with the font's
+	}
+	return handle;
+}
 
-			if (menuShown) {
-				if (componentOutlinesShown) {
-					//uiTools::drawOutline(win, t, sf::Color::White); #check
-
-					//scale componentOutlineObj to item size - must use copy to scale bevels properly
-					sf::Vector2f itemPos = textObjs[i]->getPosition();
-					float paddingAmountX = compOutlinePadding * textObjs[i]->getCharacterSize();
-					float paddingAmountY = compOutlinePadding * textObjs[i]->getCharacterSize();
-					sf::Vector2f rectSize = { textObjs[i]->getLocalBounds().width + paddingAmountX,
-						static_cast<float>(textObjs[i]->getCharacterSize()) + paddingAmountY };
-
-					float offsetX;
-					float offsetY;
-					switch (dockingPosition) {
-					case uiTools::TOP_LEFT:
-						offsetX = paddingAmountX / 2;
-						offsetY = paddingAmountY / 2;
-						break;
-					case uiTools::BOTTOM_LEFT:
-						offsetX = paddingAmountX / 2;
-						offsetY = (paddingAmountY / 2) * (-1);
-						break;
-					case uiTools::TOP_RIGHT:
-						offsetX = (paddingAmountX / 2) * (-1);
-						offsetY = paddingAmountY / 2;
-						break;
-					case uiTools::BOTTOM_RIGHT:
-						offsetX = (paddingAmountX / 2) * (-1);
-						offsetY = (paddingAmountY / 2) * (-1);
-						break;
-					}
-					sf::Vector2f rectOrigin = uiTools::cornerTypeToVector(textOriginPoint, { textObjs[i]->getLocalBounds().width + paddingAmountX,
-						static_cast<float>(textObjs[i]->getCharacterSize()) + paddingAmountY });
-					rectOrigin.x += offsetX;
-					rectOrigin.y += offsetY;
-					
-					// configure rounded rect
-					sf::ConvexShape copy = createRoundedRect(rectSize, componentOutlineObj.getFillColor(), componentOutlineObj.getOutlineThickness(), componentOutlineObj.getOutlineColor());
-					copy.setOrigin(rectOrigin);
-					copy.setPosition(itemPos);
-
-					//draw shape
-					win.draw(copy);
-				}
-				win.draw(*textObjs[i]);
-			}
-		} else {
-			break;
-		}
+bool Menu::setCounterValue(ItemHandle handle, long long value)
+{
+	if (!isValid(handle) || !itemSlots[handle.index].counter) {
+		std::cout << "ERROR: Not a counter item. (Menu::setCounterValue())\n";
+		return false;
 	}
 
-	if (menuShown && menuBoundsShown &&
-		(type == STATIC || (type == DYNAMIC && bounds.y > paddingY * 2))) {
-		win.draw(outline);
+	ItemSlot& slot = itemSlots[handle.index];
+	switch (slot.counter->setValue(value)) {
+	case CounterText::UNCHANGED:
+		break;
+	case CounterText::DIGITS_CHANGED:
+		// same width; the digits are rewritten when the counter is drawn and the render cache does not hold them
+		version++;
+		break;
+	case CounterText::LENGTH_CHANGED:
+		slot.item->setString(slot.counter->getLayoutString(slot.label));
+		markItemDirty(handle);
+		break;
 	}
+	return true;
 }
 
-void Menu::setType(menuType type) {
-	if (!initialized) {
-		type = type;
-	} else {
-		std::cout << "ERROR: trying to set type after menu has been initialized. (Menu::setType())\n";
+void Menu::removeCounter(std::uint32_t slotIndex) {
+	itemSlots[slotIndex].counter.reset();
+	batchedCounters.clear(); // the slot may be reused by another counter
+	auto found = std::find(counterSlots.begin(), counterSlots.end(), slotIndex);
+	if (found != counterSlots.end()) {
+		*found = counterSlots.back();
+		counterSlots.pop_back();
 	}
 }
 
-void Menu::toggleMenuShown() {
-	if (!menuShown) {
-		menuShown = true;
-	} else {
-		menuShown = false;
+bool Menu::removeItem(ItemHandle handle)
+{
+	if (!isValid(handle)) {
+		return false;
 	}
-}
 
-sf::Vector2f Menu::getInnerCorner(sf::Vector2f outerCorner) {
-	switch (dockingPosition) {
-	case uiTools::TOP_RIGHT:
-		return { outerCorner.x - paddingX, outerCorner.y + paddingY };
-	case uiTools::TOP_LEFT:
-		return { outerCorner.x + paddingX, outerCorner.y + paddingY };
-	case uiTools::BOTTOM_LEFT:
-		return { outerCorner.x + paddingX, outerCorner.y - paddingY };
-	case uiTools::BOTTOM_RIGHT:
-		return { outerCorner.x - paddingX, outerCorner.y - paddingY };
+	ItemSlot& slot = itemSlots[handle.index];
+	sf::Text* objToRemove = slot.item;
+
+	// leave a hole in textObjs; compactItems() closes it during the next layout
+	textObjs[slot.orderIndex] = nullptr;
+	holeCount++;
+
+	// keep the first and last entries of textObjs live items
+	while (!textObjs.empty() && textObjs.back() == NULL) {
+		textObjs.pop_back();
+		textObjSlots.pop_back();
+		holeCount--;
+	}
+	while (firstItemIndex < textObjs.size() && textObjs[firstItemIndex] == NULL) {
+		firstItemIndex++;
+	}
+	if (textObjs.empty()) {
+		firstItemIndex = 0;
 	}
 
-	return sf::Vector2f();
-}
+	// delete object and free its slot; bumping the generation invalidates existing handles
+	unindexLabel(handle.index);
+	untrackItemWidth(handle.index);
+	outlineCache.erase(objToRemove);
+	if (slot.counter) {
+		removeCounter(handle.index);
+	}
+	releaseItemAtlas(handle.index);
+	itemPool.destroy(objToRemove);
+	slot.item = nullptr;
+	slot.dirty = false; // an entry left in dirtyItems is skipped
+	slot.generation++;
+	freeSlots.push_back(handle.index);
+	numElements--;
 
-void Menu::setBounds(float x, float y) {
-	// data validation? #check
-	bounds.x = x;
-	bounds.y = y;
+	// the menu may narrow right away; its height is recalculated with the layout
+	setBounds(std::max(paddingX * 2, getWidestItemWidth() + paddingX * 2), bounds.y);
 
-	// update background and outline objects
-	background.setSize(bounds);
-	background.setOrigin(uiTools::cornerTypeToVector(dockingPosition, bounds));
-	outline.setSize(bounds);
-	outline.setOrigin(uiTools::cornerTypeToVector(dockingPosition, bounds));
+	// move the following items into the gap and recalculate menu bounds on the next draw
+	mustReformatElements = true;
+	markDirty();
+
+	return true;
 }
 
-void Menu::reformatElements(sf::RenderWindow& win)
+sf::Text* Menu::getItem(ItemHandle handle)
 {
-	// Brute force method #improve
-	// Remove all menu items, storing copies in vector
-	std::vector<sf::Text*> copies;
-	int counter = 0;
-	while (textObjs[0] != NULL) {
-		sf::Text* copy = new sf::Text(*textObjs[0]);
-		removeMenuItem(textObjs[0]);
-		copies.push_back(copy);
-		counter++;
+	if (!isValid(handle)) {
+		return nullptr;
 	}
 
-	// Re-add all items
-	for (int i = 0; i < counter; i++) {
-		addMenuItem(win, copies[i]->getString(), copies[i]);
-	}
+	return itemSlots[handle.index].item;
 }
 
-void Menu::reformatArray(sf::Text* array[], int len)
+bool Menu::isValid(ItemHandle handle) const
 {
-	// expensive - #improve
-	for (int i = 0; i < len; i++) {
-		if (array[i] == NULL) {
-			for (int j = i + 1; j < len; j++) {
-				array[j - 1] = array[j];
-			}
-		}
+	return handle.index < itemSlots.size() && itemSlots[handle.index].generation == handle.generation &&
+		itemSlots[handle.index].item != NULL;
+}
+
+bool Menu::setItemText(ItemHandle handle, const std::string text)
+{
+	sf::Text* item = getItem(handle);
+	if (!item) {
+		return false;
+	}
+
+	if (itemSlots[handle.index].counter) {
+		removeCounter(handle.index); // the item now shows plain text
 	}
+
+	unindexLabel(handle.index);
+	item->setString(text);
+	indexLabel(handle.index, text);
+	return markItemDirty(handle);
 }
 
-int Menu::getLastIndex() {
-	// can be optimized? - #check
-	// stepwise solution
-	int counter = 0;
-	int len = sizeof(textObjs) / sizeof(textObjs[0]);
-	for (int i = 0; i < len; i++) {
-		if (textObjs[i] != NULL) {
-			counter++;
-		} else {
-			break;
-		}
+bool Menu::setItemStyle(ItemHandle handle, sf::Uint32 style)
+{
+	sf::Text* item = getItem(handle);
+	if (!item) {
+		return false;
 	}
 
-	return counter - 1;
+	item->setStyle(style);
+	return markItemDirty(handle);
 }
 
-int Menu::getWidestItemIndex()
+bool Menu::setItemCharacterSize(ItemHandle handle, unsigned int size)
 {
-	int len = sizeof(textObjs) / sizeof(textObjs[0]);
-	float greatestWidth = 0;
-	int index = 0;
-	for (int i = 0; i < len; i++) {
-		if (textObjs[i] != NULL) {
-			float itemWidth = textObjs[i]->getLocalBounds().width;
-			if (itemWidth > greatestWidth) {
-				greatestWidth = itemWidth;
-				index = i;
+	sf::Text* item = getItem(handle);
+	if (!item) {
+		return false;
+	}
+
+	item->setCharacterSize(size);
+	return markItemDirty(handle);
+}
+
+bool Menu::markItemDirty(ItemHandle handle)
+{
+	if (!isValid(handle)) {
+		return false;
+	}
+
+	ItemSlot& slot = itemSlots[handle.index];
+	if (!slot.dirty) {
+		slot.dirty = true;
+		dirtyItems.push_back(handle.index);
+	}
+
+	// new glyphs are read back from the font now, not in the middle of drawing a frame
+	if (SdfFont* sdfFont = getItemSdfFont(handle.index)) {
+		sdfFont->prepare(slot.item->getString(), (slot.item->getStyle() & sf::Text::Bold) != 0);
+	}
+
+	markDirty();
+	return true;
+}
+
+void Menu::queueItemText(ItemHandle handle, std::string text)
+{
+	updateQueue.push({ handle, QueuedUpdate::TEXT, std::move(text), 0, 0 });
+}
+
+void Menu::queueItemStyle(ItemHandle handle, sf::Uint32 style)
+{
+	updateQueue.push({ handle, QueuedUpdate::STYLE, std::string(), style, 0 });
+}
+
+void Menu::queueItemCharacterSize(ItemHandle handle, unsigned int size)
+{
+	updateQueue.push({ handle, QueuedUpdate::CHARACTER_SIZE, std::string(), size, 0 });
+}
+
+void Menu::queueItemFillColor(ItemHandle handle, sf::Color color)
+{
+	updateQueue.push({ handle, QueuedUpdate::FILL_COLOR, std::string(), color.toInteger(), 0 });
+}
+
+void Menu::queueCounterValue(ItemHandle handle, long long value)
+{
+	updateQueue.push({ handle, QueuedUpdate::COUNTER_VALUE, std::string(), 0, value });
+}
+
+bool Menu::handleEvent(const sf::Event& event)
+{
+	// maps a mouse position to the item under it, through the view of the draw the mapping was taken from
+	auto itemAtPixel = [this](int x, int y) {
+		if (!inputMapped || !menuShown || inputViewport.width == 0 || inputViewport.height == 0) {
+			return ItemHandle();
+		}
+		sf::Vector2f normalized(-1.f + 2.f * (x - inputViewport.left) / inputViewport.width,
+			1.f - 2.f * (y - inputViewport.top) / inputViewport.height);
+		return getItemAt(inputView.getInverseTransform().transformPoint(normalized));
+	};
+
+	switch (event.type) {
+	case sf::Event::Resized:
+		anchorTo(sf::Vector2u(event.size.width, event.size.height));
+		return false;
+
+	case sf::Event::MouseMoved: {
+		ItemHandle item = itemAtPixel(event.mouseMove.x, event.mouseMove.y);
+		setHoveredItem(item);
+		return isValid(item);
+	}
+
+	case sf::Event::MouseLeft:
+		setHoveredItem(ItemHandle());
+		return false;
+
+	case sf::Event::MouseButtonPressed: {
+		if (event.mouseButton.button != sf::Mouse::Left) {
+			return false;
+		}
+		ItemHandle item = itemAtPixel(event.mouseButton.x, event.mouseButton.y);
+		if (!isValid(item)) {
+			return false;
+		}
+		setFocusedItem(item);
+		if (clickCallback) {
+			clickCallback(item);
+		}
+		return true;
+	}
+
+	case sf::Event::KeyPressed:
+		if (!menuShown) {
+			return false;
+		}
+		switch (event.key.code) {
+		case sf::Keyboard::Up:
+			return moveFocus(-1);
+		case sf::Keyboard::Down:
+			return moveFocus(1);
+		case sf::Keyboard::Enter:
+		case sf::Keyboard::Space:
+			if (!isValid(focusedItem)) {
+				return false;
 			}
-		} else {
-			break;
+			if (clickCallback) {
+				clickCallback(focusedItem);
+			}
+			return true;
+		default:
+			return false;
 		}
+
+	default:
+		return false;
 	}
+}
 
-	return index;
+void Menu::setHoverCallback(ItemCallback callback)
+{
+	hoverCallback = std::move(callback);
 }
 
-void Menu::applyPaddingDiff(float diffPaddingX, float diffPaddingY) {
-	// text objects
-	int len = sizeof(textObjs) / sizeof(textObjs[0]);
-	for (int i = 0; i < len; i++) {
-		if (textObjs[i] != NULL) {
-			sf::Vector2f objPosition = textObjs[i]->getPosition();
-			switch (dockingPosition) {
-			case uiTools::TOP_RIGHT:
-				textObjs[i]->setPosition(objPosition.x - diffPaddingX, objPosition.y + diffPaddingY);
-				objPosition = textObjs[i]->getPosition();
-				break;
-			case uiTools::TOP_LEFT:
-				textObjs[i]->setPosition(objPosition.x + diffPaddingX, objPosition.y + diffPaddingY);
-				break;
-			case uiTools::BOTTOM_LEFT:
-				textObjs[i]->setPosition(objPosition.x + diffPaddingX, objPosition.y - diffPaddingY);
-				break;
-			case uiTools::BOTTOM_RIGHT:
-				textObjs[i]->setPosition(objPosition.x - diffPaddingX, objPosition.y - diffPaddingY);
-				break;
-			}
+void Menu::setClickCallback(ItemCallback callback)
+{
+	clickCallback = std::move(callback);
+}
+
+void Menu::setFocusCallback(ItemCallback callback)
+{
+	focusCallback = std::move(callback);
+}
+
+bool Menu::setFocusedItem(ItemHandle handle)
+{
+	bool clearing = handle.generation == 0; // default constructed handle
+	if (!clearing && !isValid(handle)) {
+		return false;
+	}
+	if (handle == focusedItem) {
+		return true;
+	}
+
+	// only the highlight moves; the render cache does not hold it
+	focusedItem = handle;
+	version++;
+
+	if (!clearing) {
+		scrollIntoView(itemSlots[handle.index].orderIndex);
+	}
+	if (focusCallback) {
+		focusCallback(handle);
+	}
+	return true;
+}
+
+Menu::ItemHandle Menu::getHoveredItem() const
+{
+	return isValid(hoveredItem) ? hoveredItem : ItemHandle();
+}
+
+Menu::ItemHandle Menu::getFocusedItem() const
+{
+	return isValid(focusedItem) ? focusedItem : ItemHandle();
+}
+
+Menu::ItemHandle Menu::getItemAt(sf::Vector2f point)
+{
+	// rows are only known once the menu is laid out
+	if (mustReformatElements || textObjs.empty() || itemOffsets.size() != textObjs.size()) {
+		return ItemHandle();
+	}
+
+	sf::Vector2f menuPoint = inputTransform.getInverse().transformPoint(point);
+	if (!background.getGlobalBounds().contains(menuPoint)) {
+		return ItemHandle();
+	}
+
+	// items are drawn scrolled when there is a viewport
+	sf::Vector2f itemPoint = itemTransform.getInverse().transformPoint(menuPoint);
+	if (viewportHeight > 0) {
+		itemPoint.y += getScrollShift();
+	}
+
+	// itemOffsets is sorted; the row holding the point is the last one starting at or above it
+	float rowY = itemPoint.y - getContentTop() + componentBuffer / 2.f;
+	std::size_t index = std::upper_bound(itemOffsets.begin(), itemOffsets.end(), rowY) - itemOffsets.begin();
+	if (index == 0 || !getItemRow(index - 1).contains(itemPoint)) {
+		return ItemHandle();
+	}
+
+	return makeHandle(index - 1);
+}
+
+void Menu::setHighlightColor(sf::Color color)
+{
+	highlight.setFillColor(color);
+	version++;
+}
+
+void Menu::draw(sf::RenderTarget& target, const sf::RenderStates& states)
+{
+	auto drawStart = std::chrono::steady_clock::now();
+
+	// changes made by other threads since the last draw
+	if (!updateQueue.empty()) {
+		applyQueuedUpdates();
+	}
+
+	resolvePendingFont();
+	if (!defaultTextObj.getFont()) {
+		// nothing can be measured or drawn until the first font arrives
+		return;
+	}
+
+	// a single size comparison; re-anchoring moves menuTransform, not the items. Targets of
+	// different sizes only differ in this transform, so they share everything below.
+	anchorTo(target.getSize());
+
+	// only items marked as changed are measured again
+	if (!dirtyItems.empty()) {
+		updateDirtyItems();
+	}
+
+	// an open beginUpdate() batch is laid out by its commitUpdate(), not part-way through
+	if (mustReformatElements && updateDepth == 0) {
+		layoutElements();
+		mustReformatElements = false;
+		markDirty();
+	}
+
+	if (componentOutlinesShown && (componentOutlineObj.getFillColor() != cachedOutlineFillColor ||
+		componentOutlineObj.getOutlineThickness() != cachedOutlineThickness ||
+		componentOutlineObj.getOutlineColor() != cachedOutlineColor)) {
+		// componentOutlineObj style was changed; cached outlines are stale
+		cachedOutlineFillColor = componentOutlineObj.getFillColor();
+		cachedOutlineThickness = componentOutlineObj.getOutlineThickness();
+		cachedOutlineColor = componentOutlineObj.getOutlineColor();
+		clearOutlineCache();
+		markDirty();
+	}
+
+	// only the items in view are positioned and drawn
+	updateVisibleRange();
+
+	if (cachedRendering && cacheDirty) {
+		updateRenderCache();
+	}
+
+	sf::RenderStates menuStates = states;
+	menuStates.transform *= menuTransform;
+
+	// remember how the target maps to the menu so handleEvent() can hit test mouse positions.
+	// Once the menu was drawn to a window, offscreen targets (minimaps, captures) leave the mapping alone.
+	bool isWindow = dynamic_cast<sf::RenderWindow*>(&target) != nullptr;
+	if (isWindow || !inputFromWindow) {
+		inputMapped = true;
+		inputFromWindow = isWindow;
+		inputView = target.getView();
+		inputViewport = target.getViewport(inputView);
+		inputTransform = menuStates.transform;
+	}
+
+	if (cachedRendering && cacheValid) {
+		// cache holds premultiplied colors: the caller's blend mode is kept, except that the source
+		// color is no longer weighted by its alpha (for BlendAlpha this gives One, OneMinusSrcAlpha)
+		if (menuStates.blendMode.colorSrcFactor == sf::BlendMode::SrcAlpha) {
+			menuStates.blendMode.colorSrcFactor = sf::BlendMode::One;
 		}
+		target.draw(cacheSprite, menuStates);
+		stats.drawCalls++;
+		stats.vertices += 4;
+
+		menuStates.blendMode = states.blendMode;
+		drawOverCache(target, menuStates);
+	} else {
+		drawComponents(target, menuStates);
+	}
+
+	stats.drawMicroseconds += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - drawStart).count();
+
+	// not counted in the stats it shows; hidden along with the menu it sits beside
+	if (statsOverlayShown && menuShown) {
+		drawStatsOverlay(target, states);
 	}
 }
 
-void Menu::applyCompBufferDiff(int diff) {
-	// text objects
-	int len = sizeof(textObjs) / sizeof(textObjs[0]);
-	int counter = 1;
-	for (int i = 1; i < len; i++) {
-		if (textObjs[i] != NULL) {
-			counter++;
-			sf::Vector2f currentPos = textObjs[i]->getPosition();
+void Menu::setType(menuType type) {
+	if (!initialized) {
+		this->type = type;
+	} else {
+		std::cout << "ERROR: trying to set type after menu has been initialized. (Menu::setType())\n";
+	}
+}
 
-			if (dockingPosition == uiTools::TOP_LEFT || dockingPosition == uiTools::TOP_RIGHT) {
-				textObjs[i]->setPosition(currentPos.x, currentPos.y + i * diff);
-			}
-		} else {
-			if (dockingPosition == uiTools::BOTTOM_LEFT || dockingPosition == uiTools::BOTTOM_RIGHT) {
-				for (int i = counter - 1; i >= 0; i--) {
-					sf::Vector2f currentPos = textObjs[i]->getPosition();
-					textObjs[i]->setPosition(currentPos.x, currentPos.y - (counter - i - 1) * diff);
-				}
-			}
+void Menu::toggleMenuShown() {
+	if (!menuShown) {
+		menuShown = true;
+	} else {
+		menuShown = false;
+	}
+	markDirty();
+}
 
-			break;
+sf::Vector2f Menu::getInnerCorner(sf::Vector2f outerCorner) {
+	switch (dockingPosition) {
+	case uiTools::TOP_RIGHT:
+		return { outerCorner.x - paddingX, outerCorner.y + paddingY };
+	case uiTools::TOP_LEFT:
+		return { outerCorner.x + paddingX, outerCorner.y + paddingY };
+	case uiTools::BOTTOM_LEFT:
+		return { outerCorner.x + paddingX, outerCorner.y - paddingY };
+	case uiTools::BOTTOM_RIGHT:
+		return { outerCorner.x - paddingX, outerCorner.y - paddingY };
+	}
+
+	return sf::Vector2f();
+}
+
+void Menu::anchorTo(sf::Vector2u windowSize) {
+	if (windowSize != cachedWindowSize) {
+		cachedWindowSize = windowSize;
+		updateTransform();
+	}
+}
+
+void Menu::updateTransform() {
+	sf::Vector2f windowBounds = { static_cast<float>(cachedWindowSize.x), static_cast<float>(cachedWindowSize.y) };
+	menuTransform = sf::Transform::Identity;
+	menuTransform.translate(uiTools::cornerTypeToVector(dockingPosition, windowBounds) + offset);
+
+	itemTransform = sf::Transform::Identity;
+	itemTransform.translate(getInnerCorner(sf::Vector2f()));
+
+	// only moves the menu; neither the version nor the render cache changes, so drawing to
+	// targets of different sizes in turn does not look like the menu changing every draw
+}
+
+void Menu::setBounds(float x, float y) {
+	// data validation? #check
+	bounds.x = x;
+	bounds.y = y;
+
+	// a viewport caps the height the menu takes up on screen
+	sf::Vector2f shownSize = bounds;
+	if (viewportHeight > 0) {
+		shownSize.y = std::min(bounds.y, viewportHeight + paddingY * 2);
+	}
+
+	// update background and outline objects
+	background.setSize(shownSize);
+	background.setOrigin(uiTools::cornerTypeToVector(dockingPosition, shownSize));
+	outline.setSize(shownSize);
+	outline.setOrigin(uiTools::cornerTypeToVector(dockingPosition, shownSize));
+
+	// the list may have become shorter than the current scroll offset
+	scrollOffset = std::min(scrollOffset, getMaxScrollOffset());
+}
+
+void Menu::layoutElements()
+{
+	auto layoutStart = std::chrono::steady_clock::now();
+	compactItems();
+
+	bool stackDownwards = dockingPosition == uiTools::TOP_LEFT || dockingPosition == uiTools::TOP_RIGHT;
+	int count = numElements;
+
+	// bounds start out as just the padding
+	float boundsX = std::max(paddingX * 2, getWidestItemWidth() + paddingX * 2);
+	float boundsY = paddingY * 2;
+
+	// offsets only need the character sizes, so they are rebuilt for every item
+	itemOffsets.resize(count);
+	float offset = 0;
+	for (int i = 0; i < count; i++) {
+		unsigned int characterSize = textObjs[i]->getCharacterSize();
+		itemSlots[textObjSlots[i]].characterSize = characterSize;
+		itemOffsets[i] = offset;
+		offset += characterSize + componentBuffer;
+	}
+	layoutCount++;
+
+	// same bounds updateBounds() builds up one item at a time
+	if (count > 0) {
+		float firstHeight = static_cast<float>(textObjs[0]->getCharacterSize());
+		boundsY += offset - componentBuffer + firstHeight * compOutlinePadding / 2;
+	}
+
+	// with a viewport, items are positioned when they scroll into view
+	if (viewportHeight <= 0) {
+		// single sweep starting at the item that sits in the inner corner (item space origin)
+		float y = 0;
+		for (int step = 0; step < count; step++) {
+			int i = stackDownwards ? step : count - 1 - step;
+			sf::Text* item = textObjs[i];
+			float itemHeight = static_cast<float>(item->getCharacterSize());
+
+			setItemOrigin(textObjSlots[i], textOriginPoint);
+			item->setPosition(0, y);
+
+			if (stackDownwards)
+				y += itemHeight + componentBuffer;
+			else
+				y -= itemHeight + componentBuffer;
 		}
 	}
+
+	setBounds(boundsX, boundsY);
+
+	stats.layoutRuns++;
+	stats.layoutMicroseconds += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - layoutStart).count();
+}
+
+void Menu::setItemOrigin(std::uint32_t slotIndex, uiTools::cornerType originPoint) {
+	uiTools::setObjectOrigin(*itemSlots[slotIndex].item, originPoint, measureItem(slotIndex).bounds);
+}
+
+TextMetrics Menu::measureItem(std::uint32_t slotIndex) {
+	return textMetrics.measure(*itemSlots[slotIndex].item, getItemSdfFont(slotIndex));
+}
+
+SdfFont* Menu::getItemSdfFont(std::uint32_t slotIndex) {
+	ItemSlot& slot = itemSlots[slotIndex];
+	const sf::Font* font = (slot.counter || !sdfText) ? nullptr : slot.item->getFont();
+	SdfFont* sdfFont = getSdfFont(font);
+
+	// the item moved to another atlas (its font changed, or it became a counter)
+	if (font != slot.atlasFont) {
+		releaseItemAtlas(slotIndex);
+		slot.atlasFont = font;
+		if (font)
+			sdfFonts[font].items++;
+	}
+	return sdfFont;
+}
+
+void Menu::releaseItemAtlas(std::uint32_t slotIndex) {
+	ItemSlot& slot = itemSlots[slotIndex];
+	if (!slot.atlasFont) {
+		return;
+	}
+
+	auto found = sdfFonts.find(slot.atlasFont);
+	if (found != sdfFonts.end() && --found->second.items == 0) {
+		sdfFonts.erase(found);
+	}
+	slot.atlasFont = nullptr;
+}
+
+SdfFont* Menu::getSdfFont(const sf::Font* font) {
+	if (!sdfText || !font) {
+		return nullptr;
+	}
+
+	std::unique_ptr<SdfFont>& sdfFont = sdfFonts[font].font;
+	if (!sdfFont) {
+		// one glyph page readback for the common characters, instead of one per new character later
+		sdfFont = std::make_unique<SdfFont>(*font);
+		sdfFont->prepare(FontRegistry::PRINTABLE_ASCII, false);
+	}
+	return sdfFont.get();
+}
+
+void Menu::requestLayout() {
+	if (updateDepth > 0 || pendingFont.valid()) {
+		mustReformatElements = true; // laid out by commitUpdate() or once the font arrives
+	} else {
+		layoutElements();
+	}
+}
+
+void Menu::reserveItems(std::size_t count) {
+	std::size_t total = textObjs.size() + count;
+	textObjs.reserve(total);
+	textObjSlots.reserve(total);
+	itemOffsets.reserve(total);
+	itemSlots.reserve(itemSlots.size() + count);
+	labelIndex.reserve(labelIndex.size() + count);
+}
+
+int Menu::getLastIndex() {
+	return static_cast<int>(textObjs.size()) - 1;
 }
 
 sf::Text* Menu::addTextObj(const sf::Text& objToUse, int& index) {
-	int len = sizeof(textObjs) / sizeof(textObjs[0]);
-	for (int x = 0; x < len; x++) {
-		if (textObjs[x] == NULL) {
-			textObjs[x] = new sf::Text(objToUse);
-			index = x;
-			return textObjs[x];
+	sf::Text* addedItem = itemPool.create(objToUse);
+
+	// reuse a free handle slot if there is one
+	std::uint32_t slotIndex;
+	if (!freeSlots.empty()) {
+		slotIndex = freeSlots.back();
+		freeSlots.pop_back();
+	} else {
+		slotIndex = static_cast<std::uint32_t>(itemSlots.size());
+		itemSlots.push_back({ nullptr, 1, 0, std::string(), 0, itemWidths.end(), 0, false, false, 0, nullptr,
+			RenderBatch::Range(), sf::Transform(), nullptr });
+	}
+	itemSlots[slotIndex].item = addedItem;
+	itemSlots[slotIndex].placedLayout = 0;
+	itemSlots[slotIndex].dirty = false;
+	itemSlots[slotIndex].characterSize = addedItem->getCharacterSize();
+	itemSlots[slotIndex].orderIndex = textObjs.size();
+
+	textObjs.push_back(addedItem);
+	textObjSlots.push_back(slotIndex);
+	index = getLastIndex();
+	return addedItem;
+}
+
+void Menu::compactItems() {
+	if (holeCount == 0) {
+		return;
+	}
+
+	std::size_t count = 0;
+	for (std::size_t i = firstItemIndex; i < textObjs.size(); i++) {
+		if (textObjs[i] != NULL) {
+			textObjs[count] = textObjs[i];
+			textObjSlots[count] = textObjSlots[i];
+			itemSlots[textObjSlots[count]].orderIndex = count;
+			count++;
 		}
 	}
-	return nullptr;
+
+	textObjs.resize(count);
+	textObjSlots.resize(count);
+	holeCount = 0;
+	firstItemIndex = 0;
 }
 
-sf::Vector2f Menu::calculateTextObjPosition(sf::Text* lastElementAdded, const sf::RenderWindow& win) {
-	sf::Vector2f outerCorner = uiTools::cornerTypeToVector(dockingPosition, { static_cast<float>(win.getSize().x), static_cast<float>(win.getSize().y) });
-	sf::Vector2f innerCorner = getInnerCorner(outerCorner);
+void Menu::placeItem(std::size_t index) {
+	sf::Text* item = textObjs[index];
+	float y = getContentTop() + itemOffsets[index];
 
-	if (lastElementAdded != nullptr) {
-		return { innerCorner.x, lastElementAdded->getPosition().y + lastElementAdded->getCharacterSize() + componentBuffer };
+	// bottom docked items are positioned by their bottom edge
+	if (dockingPosition == uiTools::BOTTOM_LEFT || dockingPosition == uiTools::BOTTOM_RIGHT) {
+		y += item->getCharacterSize();
+	}
+
+	setItemOrigin(textObjSlots[index], textOriginPoint);
+	item->setPosition(0, y);
+	itemSlots[textObjSlots[index]].placedLayout = layoutCount;
+}
+
+void Menu::updateVisibleRange() {
+	if (viewportHeight <= 0 || itemOffsets.size() != textObjs.size()) {
+		visibleBegin = 0;
+		visibleEnd = textObjs.size();
+		return;
+	}
+
+	// part of the item list shown in the menu area, relative to the top of the first item
+	sf::FloatRect clip = itemTransform.getInverse().transformRect(background.getGlobalBounds());
+	float shownTop = clip.top + getScrollShift() - getContentTop();
+	float shownBottom = shownTop + clip.height;
+
+	// itemOffsets is sorted; the item containing shownTop is the last one starting at or above it.
+	// One more item on each side is kept for component outlines that reach past their item.
+	std::size_t first = std::upper_bound(itemOffsets.begin(), itemOffsets.end(), shownTop) - itemOffsets.begin();
+	std::size_t last = std::lower_bound(itemOffsets.begin(), itemOffsets.end(), shownBottom) - itemOffsets.begin();
+	visibleBegin = first >= 2 ? first - 2 : 0;
+	visibleEnd = std::min(last + 1, textObjs.size());
+
+	for (std::size_t i = visibleBegin; i < visibleEnd; i++) {
+		if (itemSlots[textObjSlots[i]].placedLayout != layoutCount) {
+			placeItem(i);
+		}
+	}
+}
+
+float Menu::getContentTop() {
+	if (dockingPosition == uiTools::TOP_LEFT || dockingPosition == uiTools::TOP_RIGHT || textObjs.empty()) {
+		return 0;
+	}
+
+	// bottom docked lists end at the inner corner
+	return -(itemOffsets.back() + textObjs.back()->getCharacterSize());
+}
+
+float Menu::getScrollShift() const {
+	if (dockingPosition == uiTools::TOP_LEFT || dockingPosition == uiTools::TOP_RIGHT) {
+		return scrollOffset;
 	} else {
-		return innerCorner;
+		return -scrollOffset;
+	}
+}
+
+sf::View Menu::getClipView(const sf::RenderTarget& target, const sf::Transform& transform) const {
+	sf::FloatRect clip = transform.transformRect(background.getGlobalBounds());
+
+	// snap the menu area to whole pixels so items are not resampled
+	sf::Vector2i topLeft = target.mapCoordsToPixel({ clip.left, clip.top });
+	sf::Vector2i bottomRight = target.mapCoordsToPixel({ clip.left + clip.width, clip.top + clip.height });
+	sf::Vector2f snappedTopLeft = target.mapPixelToCoords(topLeft);
+	sf::Vector2f snappedBottomRight = target.mapPixelToCoords(bottomRight);
+
+	sf::View view(sf::FloatRect(snappedTopLeft.x, snappedTopLeft.y + getScrollShift(),
+		snappedBottomRight.x - snappedTopLeft.x, snappedBottomRight.y - snappedTopLeft.y));
+
+	sf::Vector2f targetSize = { static_cast<float>(target.getSize().x), static_cast<float>(target.getSize().y) };
+	view.setViewport(sf::FloatRect(topLeft.x / targetSize.x, topLeft.y / targetSize.y,
+		(bottomRight.x - topLeft.x) / targetSize.x, (bottomRight.y - topLeft.y) / targetSize.y));
+	return view;
+}
+
+void Menu::applyQueuedUpdates() {
+	appliedFields.resize(itemSlots.size(), 0);
+
+	// newest first, so the first change seen for an item and field is the one that wins
+	updateQueue.consumeNewestFirst([this](QueuedUpdate& update) {
+		if (!isValid(update.handle)) {
+			return; // item was removed after the change was queued
+		}
+
+		std::uint8_t fieldBit = static_cast<std::uint8_t>(1 << update.field);
+		std::uint8_t& applied = appliedFields[update.handle.index];
+		if (applied & fieldBit) {
+			return; // overwritten by a later change
+		}
+		if (applied == 0) {
+			updatedSlots.push_back(update.handle.index);
+		}
+		applied |= fieldBit;
+		survivingUpdates.push_back(std::move(update));
+	});
+
+	// the changes that won are applied in the order they were queued, so a change to one field
+	// sees the changes queued before it to other fields (e.g. a counter value after its text)
+	for (auto found = survivingUpdates.rbegin(); found != survivingUpdates.rend(); ++found) {
+		QueuedUpdate& update = *found;
+		switch (update.field) {
+		case QueuedUpdate::TEXT:
+			setItemText(update.handle, std::move(update.text));
+			break;
+		case QueuedUpdate::STYLE:
+			setItemStyle(update.handle, update.value);
+			break;
+		case QueuedUpdate::CHARACTER_SIZE:
+			setItemCharacterSize(update.handle, update.value);
+			break;
+		case QueuedUpdate::FILL_COLOR:
+			getItem(update.handle)->setFillColor(sf::Color(update.value));
+			markDirty();
+			break;
+		case QueuedUpdate::COUNTER_VALUE:
+			setCounterValue(update.handle, update.number);
+			break;
+		}
 	}
+	survivingUpdates.clear();
+
+	for (std::uint32_t slotIndex : updatedSlots) {
+		appliedFields[slotIndex] = 0;
+	}
+	updatedSlots.clear();
 }
 
-void Menu::movePreviousElements(int index, const sf::RenderWindow& win) {
-	sf::Vector2f outerCorner = uiTools::cornerTypeToVector(dockingPosition, { static_cast<float>(win.getSize().x), static_cast<float>(win.getSize().y) });
-	sf::Vector2f innerCorner = getInnerCorner(outerCorner);
-	textObjs[index]->setPosition(innerCorner);
+void Menu::resolvePendingFont() {
+	if (!isFontLoaded() || !pendingFont.valid()) {
+		return;
+	}
 
-	for (int i = index - 1; i >= 0; i--) {
-		sf::Text* lastElementAdded = textObjs[i + 1];
-		float newY = lastElementAdded->getPosition().y - lastElementAdded->getCharacterSize() - componentBuffer;
-		textObjs[i]->setPosition(textObjs[i]->getPosition().x, newY);
+	std::shared_ptr<sf::Font> font = pendingFont.get();
+	pendingFont = FontRegistry::FontFuture();
+	if (!font) {
+		std::cout << "ERROR: Error loading Menu font\n";
+		font = backupFontObj ? backupFontObj : std::make_shared<sf::Font>();
 	}
+
+	// keep every font items may still use
+	if (std::find(fonts.begin(), fonts.end(), font) == fonts.end()) {
+		fonts.push_back(font);
+	}
+	if (!backupFontObj) {
+		backupFontObj = font;
+		statsOverlay.setFont(*backupFontObj);
+	}
+	defaultTextObj.setFont(*font);
+
+	// items added while the font was loading could not be measured
+	bool itemsChanged = false;
+	for (std::uint32_t i = 0; i < itemSlots.size(); i++) {
+		ItemSlot& slot = itemSlots[i];
+		if (slot.item && slot.awaitingFont) {
+			slot.item->setFont(*font);
+			slot.awaitingFont = false;
+			untrackItemWidth(i);
+			trackItemWidth(i);
+			itemsChanged = true;
+		}
+	}
+
+	// one layout for all of them, on the next draw
+	if (itemsChanged) {
+		mustReformatElements = true;
+	}
+	markDirty();
 }
 
-void Menu::updateBounds(const sf::Text* addedItem, int addedItemHeight) {
-	sf::FloatRect addedItemBounds = addedItem->getLocalBounds();
-	float newBoundsX = bounds.x;
-	float newBoundsY = 0;
+void Menu::updateDirtyItems() {
+	for (std::uint32_t slotIndex : dirtyItems) {
+		ItemSlot& slot = itemSlots[slotIndex];
+		if (!slot.item || !slot.dirty) {
+			continue; // removed since it was marked
+		}
+		slot.dirty = false;
+
+		untrackItemWidth(slotIndex);
+		trackItemWidth(slotIndex);
+
+		if (slot.item->getCharacterSize() != slot.characterSize) {
+			// the items after it move; the layout realigns this one too
+			mustReformatElements = true;
+		} else if (viewportHeight <= 0 || slot.placedLayout == layoutCount) {
+			// keeps the item aligned to its corner (e.g. right aligned when right docked)
+			setItemOrigin(slotIndex, textOriginPoint);
+		}
+	}
+	dirtyItems.clear();
+
+	setBounds(std::max(paddingX * 2, getWidestItemWidth() + paddingX * 2), bounds.y);
+	markDirty();
+}
+
+Menu::ItemHandle Menu::makeHandle(std::size_t index) const {
+	ItemHandle handle;
+	handle.index = textObjSlots[index];
+	handle.generation = itemSlots[handle.index].generation;
+	return handle;
+}
 
-	if (addedItemBounds.width + paddingX * 2 + addedItemHeight * compOutlinePadding / 2 > bounds.x) {
-		newBoundsX = addedItemBounds.width + paddingX * 2 + addedItemHeight * compOutlinePadding / 2;
+sf::Vector2f Menu::calculateTextObjPosition(sf::Text* lastElementAdded) {
+	if (lastElementAdded != nullptr) {
+		return { 0, lastElementAdded->getPosition().y + lastElementAdded->getCharacterSize() + componentBuffer };
+	} else {
+		return sf::Vector2f(); // first item sits in the inner corner
 	}
+}
+
+void Menu::updateBounds(int addedItemHeight) {
+	float newBoundsX = std::max(bounds.x, getWidestItemWidth() + paddingX * 2);
+	float newBoundsY = 0;
+
 	if (numElements == 0) {
 		newBoundsY = bounds.y + addedItemHeight + addedItemHeight * compOutlinePadding / 2;
 	} else {
 		newBoundsY = bounds.y + addedItemHeight + componentBuffer;
 	}
 	setBounds(newBoundsX, newBoundsY);
+}
+
+geometry::RoundedRectShape<>& Menu::getComponentOutline(std::uint32_t slotIndex) {
+	const sf::Text& item = *itemSlots[slotIndex].item;
+	auto cached = outlineCache.find(&item);
+	if (cached != outlineCache.end()) {
+		OutlineCacheEntry& entry = cached->second;
+		if (entry.characterSize == item.getCharacterSize() && entry.font == item.getFont() &&
+			entry.style == item.getStyle() && entry.string == item.getString()) {
+			return entry.shape;
+		}
+	}
+
+	//scale componentOutlineObj to item size - must use copy to scale bevels properly
+	float paddingAmountX = compOutlinePadding * item.getCharacterSize();
+	float paddingAmountY = compOutlinePadding * item.getCharacterSize();
+	sf::Vector2f rectSize = { measureItem(slotIndex).bounds.width + paddingAmountX,
+		static_cast<float>(item.getCharacterSize()) + paddingAmountY };
+
+	float offsetX = 0;
+	float offsetY = 0;
+	switch (dockingPosition) {
+	case uiTools::TOP_LEFT:
+		offsetX = paddingAmountX / 2;
+		offsetY = paddingAmountY / 2;
+		break;
+	case uiTools::BOTTOM_LEFT:
+		offsetX = paddingAmountX / 2;
+		offsetY = (paddingAmountY / 2) * (-1);
+		break;
+	case uiTools::TOP_RIGHT:
+		offsetX = (paddingAmountX / 2) * (-1);
+		offsetY = paddingAmountY / 2;
+		break;
+	case uiTools::BOTTOM_RIGHT:
+		offsetX = (paddingAmountX / 2) * (-1);
+		offsetY = (paddingAmountY / 2) * (-1);
+		break;
+	}
+	sf::Vector2f rectOrigin = uiTools::cornerTypeToVector(textOriginPoint, rectSize);
+	rectOrigin.x += offsetX;
+	rectOrigin.y += offsetY;
+
+	// configure rounded rect
+	OutlineCacheEntry& entry = outlineCache[&item];
+	stats.outlinesBuilt++;
+	// the entry's shape is reused; its geometry is rebuilt once, after the outline thickness is known
+	if (entry.shape.getOutlineThickness() != componentOutlineObj.getOutlineThickness()) {
+		entry.shape.setOutlineThickness(componentOutlineObj.getOutlineThickness());
+	}
+	entry.shape.setFillColor(componentOutlineObj.getFillColor());
+	entry.shape.setOutlineColor(componentOutlineObj.getOutlineColor());
+	entry.shape.setGeometry(rectSize, 0.2f);
+	entry.shape.setOrigin(rectOrigin);
+	entry.string = item.getString();
+	entry.characterSize = item.getCharacterSize();
+	entry.font = item.getFont();
+	entry.style = item.getStyle();
+
+	return entry.shape;
+}
+
+void Menu::clearOutlineCache() {
+	outlineCache.clear();
+}
+
+void Menu::drawComponents(sf::RenderTarget& target, const sf::RenderStates& states, bool includeLive)
+{
+	if (batchedRendering)
+		renderBatch.clear();
+
+	// draw background
+	if (type == STATIC || numElements > 0) {
+		if (batchedRendering)
+			renderBatch.addShape(background);
+		else
+			drawObject(target, background, states);
+	}
+
+	// items are clipped to the menu area when scrolling
+	bool clipItems = viewportHeight > 0 && menuShown;
+	sf::View targetView = target.getView();
+	if (clipItems) {
+		if (batchedRendering) {
+			drawBatch(target, states);
+			renderBatch.clear();
+		}
+		target.setView(getClipView(target, states.transform));
+	}
+
+	// text objects are positioned in item space
+	sf::RenderStates itemStates = states;
+	itemStates.transform *= itemTransform;
+	if (includeLive && menuShown) {
+		drawHighlight(target, itemStates);
+	}
+	for (std::size_t i = visibleBegin; i < visibleEnd; i++) {
+		sf::Text* item = textObjs[i];
+		if (menuShown) {
+			if (componentOutlinesShown) {
+				//uiTools::drawOutline(win, t, sf::Color::White); #check
+
+				// geometry is cached per item; only the position is refreshed each frame
+				geometry::RoundedRectShape<>& componentOutline = getComponentOutline(textObjSlots[i]);
+				componentOutline.setPosition(item->getPosition());
+
+				//draw shape
+				if (batchedRendering)
+					renderBatch.addRoundedRect(componentOutline, itemTransform);
+				else
+					drawObject(target, componentOutline, itemStates);
+			}
+
+			SdfFont* sdfFont = getItemSdfFont(textObjSlots[i]);
+			if (itemSlots[textObjSlots[i]].counter) {
+				if (includeLive)
+					drawCounter(target, textObjSlots[i], itemStates);
+			} else if (sdfFont)
+				drawSdfText(target, *item, *sdfFont, itemStates);
+			else if (batchedRendering)
+				renderBatch.addText(*item, itemTransform);
+			else
+				drawObject(target, *item, itemStates);
+		}
+	}
+
+	if (clipItems) {
+		if (batchedRendering) {
+			drawBatch(target, states);
+			renderBatch.clear();
+			drawCounterBatch(target, states);
+		}
+		target.setView(targetView);
+	}
+
+	if (menuShown && menuBoundsShown &&
+		(type == STATIC || (type == DYNAMIC && bounds.y > paddingY * 2))) {
+		if (batchedRendering)
+			renderBatch.addShape(outline);
+		else
+			drawObject(target, outline, states);
+	}
+
+	if (batchedRendering) {
+		drawBatch(target, states);
+		if (!clipItems)
+			drawCounterBatch(target, states);
+	}
+}
+
+void Menu::drawOverCache(sf::RenderTarget& target, const sf::RenderStates& states)
+{
+	if (!menuShown || (counterSlots.empty() && !isValid(hoveredItem) && !isValid(focusedItem))) {
+		return;
+	}
+
+	sf::View targetView = target.getView();
+	if (viewportHeight > 0) {
+		target.setView(getClipView(target, states.transform));
+	}
+	if (batchedRendering)
+		renderBatch.clear();
+
+	sf::RenderStates itemStates = states;
+	itemStates.transform *= itemTransform;
+	drawHighlight(target, itemStates);
+	for (std::uint32_t slotIndex : counterSlots) {
+		ItemSlot& slot = itemSlots[slotIndex];
+		if (slot.orderIndex >= visibleBegin && slot.orderIndex < visibleEnd) {
+			drawCounter(target, slotIndex, itemStates);
+		}
+	}
+
+	if (batchedRendering) {
+		drawBatch(target, states);
+		drawCounterBatch(target, states);
+	}
+	target.setView(targetView);
+}
+
+void Menu::drawHighlight(sf::RenderTarget& target, const sf::RenderStates& states)
+{
+	ItemHandle shown = isValid(hoveredItem) ? hoveredItem : focusedItem;
+	if (!isValid(shown) || highlight.getFillColor() == sf::Color::Transparent || itemOffsets.size() != textObjs.size()) {
+		return;
+	}
+
+	// the shape's geometry is only rebuilt when the highlighted row moved or resized
+	sf::FloatRect row = getItemRow(itemSlots[shown.index].orderIndex);
+	if (highlight.getPosition() != sf::Vector2f(row.left, row.top)) {
+		highlight.setPosition(row.left, row.top);
+	}
+	if (highlight.getSize() != sf::Vector2f(row.width, row.height)) {
+		highlight.setSize(sf::Vector2f(row.width, row.height));
+	}
+
+	if (batchedRendering)
+		renderBatch.addShape(highlight, itemTransform);
+	else
+		drawObject(target, highlight, states);
+}
+
+sf::FloatRect Menu::getItemRow(std::size_t index) {
+	// rows meet halfway between items, so there is no gap between them
+	sf::FloatRect area = itemTransform.getInverse().transformRect(background.getGlobalBounds());
+	float top = getContentTop() + itemOffsets[index] - componentBuffer / 2.f;
+	float height = static_cast<float>(itemSlots[textObjSlots[index]].characterSize + componentBuffer);
+	return sf::FloatRect(area.left, top, area.width, height);
+}
+
+void Menu::setHoveredItem(ItemHandle handle) {
+	if (!isValid(handle)) {
+		handle = ItemHandle();
+	}
+	if (handle == hoveredItem) {
+		return;
+	}
+
+	// only the highlight moves; the render cache does not hold it
+	hoveredItem = handle;
+	version++;
+
+	if (hoverCallback) {
+		hoverCallback(handle);
+	}
+}
+
+bool Menu::moveFocus(int step) {
+	long long index;
+	if (isValid(focusedItem)) {
+		index = static_cast<long long>(itemSlots[focusedItem.index].orderIndex) + step;
+	} else {
+		index = step > 0 ? static_cast<long long>(firstItemIndex) : static_cast<long long>(textObjs.size()) - 1;
+	}
+
+	// skip the holes left by removals that are not laid out yet
+	long long end = static_cast<long long>(textObjs.size());
+	while (index >= static_cast<long long>(firstItemIndex) && index < end && textObjs[index] == NULL) {
+		index += step;
+	}
+	if (index < static_cast<long long>(firstItemIndex) || index >= end) {
+		return false;
+	}
+
+	return setFocusedItem(makeHandle(static_cast<std::size_t>(index)));
+}
+
+void Menu::scrollIntoView(std::size_t index) {
+	if (viewportHeight <= 0 || mustReformatElements || itemOffsets.size() != textObjs.size()) {
+		return;
+	}
+
+	// part of the item list currently shown inside the padding, in item coordinates
+	sf::FloatRect area = itemTransform.getInverse().transformRect(background.getGlobalBounds());
+	float shift = getScrollShift();
+	float shownTop = area.top + paddingY + shift;
+	float shownBottom = area.top + area.height - paddingY + shift;
+
+	sf::FloatRect row = getItemRow(index);
+	if (row.top < shownTop) {
+		shift -= shownTop - row.top;
+	} else if (row.top + row.height > shownBottom) {
+		shift += row.top + row.height - shownBottom;
+	} else {
+		return;
+	}
+
+	bool topDocked = dockingPosition == uiTools::TOP_LEFT || dockingPosition == uiTools::TOP_RIGHT;
+	setScrollOffset(topDocked ? shift : -shift);
+}
+
+void Menu::drawCounter(sf::RenderTarget& target, std::uint32_t slotIndex, const sf::RenderStates& states)
+{
+	if (batchedRendering) {
+		frameCounters.push_back(slotIndex);
+		return;
+	}
+
+	const sf::Text& item = *itemSlots[slotIndex].item;
+	CounterText& counter = *itemSlots[slotIndex].counter;
+	const sf::VertexArray& quads = counter.update(item);
+	if (quads.getVertexCount() != 0) {
+		sf::RenderStates counterStates = states;
+		counterStates.transform *= item.getTransform();
+		counterStates.texture = counter.getTexture();
+		target.draw(quads, counterStates);
+		stats.drawCalls++;
+		stats.vertices += quads.getVertexCount();
+	}
+}
+
+void Menu::drawCounterBatch(sf::RenderTarget& target, const sf::RenderStates& states)
+{
+	// bring every counter's quads up to date, and check whether their runs in the batch still fit
+	bool rebuild = frameCounters != batchedCounters;
+	for (std::uint32_t slotIndex : frameCounters) {
+		ItemSlot& slot = itemSlots[slotIndex];
+		const sf::VertexArray& quads = slot.counter->update(*slot.item);
+		sf::Transform transform = itemTransform * slot.item->getTransform();
+		if (quads.getVertexCount() != slot.counterRange.count || slot.counter->getTexture() != slot.counterRange.texture ||
+			!std::equal(transform.getMatrix(), transform.getMatrix() + 16, slot.counterTransform.getMatrix())) {
+			rebuild = true;
+		}
+	}
+
+	if (rebuild) {
+		counterBatch.clear();
+		for (std::uint32_t slotIndex : frameCounters) {
+			ItemSlot& slot = itemSlots[slotIndex];
+			slot.counterTransform = itemTransform * slot.item->getTransform();
+			slot.counterRange = counterBatch.addVertices(slot.counter->update(*slot.item), slot.counter->getTexture(), slot.counterTransform);
+		}
+		batchedCounters = frameCounters;
+	} else {
+		// only the digits that changed are copied
+		for (std::uint32_t slotIndex : frameCounters) {
+			ItemSlot& slot = itemSlots[slotIndex];
+			std::pair<std::size_t, std::size_t> changed = slot.counter->getChangedVertices();
+			if (changed.first != changed.second) {
+				counterBatch.patchVertices(slot.counterRange, slot.counter->update(*slot.item), changed.first, changed.second, slot.counterTransform);
+			}
+		}
+	}
+	frameCounters.clear();
+
+	counterBatch.draw(target, states);
+	stats.drawCalls += counterBatch.getDrawCallCount();
+	stats.vertices += counterBatch.getVertexCount();
+}
+
+void Menu::drawSdfText(sf::RenderTarget& target, const sf::Text& item, SdfFont& sdfFont, const sf::RenderStates& states)
+{
+	sdfVertices.clear();
+	sdfFont.appendText(sdfVertices, item);
+	if (sdfVertices.getVertexCount() == 0) {
+		return;
+	}
+
+	if (batchedRendering) {
+		renderBatch.addVertices(sdfVertices, &sdfFont.getTexture(), itemTransform * item.getTransform(), SdfFont::getShader());
+	} else {
+		sf::RenderStates sdfStates = states;
+		sdfStates.transform *= item.getTransform();
+		sdfStates.texture = &sdfFont.getTexture();
+		sdfStates.shader = SdfFont::getShader();
+		target.draw(sdfVertices, sdfStates);
+		stats.drawCalls++;
+		stats.vertices += sdfVertices.getVertexCount();
+	}
+}
+
+void Menu::drawObject(sf::RenderTarget& target, const sf::Shape& shape, const sf::RenderStates& states)
+{
+	target.draw(shape, states);
+
+	// a triangle fan for the fill and a triangle strip for the outline
+	std::size_t points = shape.getPointCount();
+	stats.drawCalls++;
+	stats.vertices += points + 2;
+	if (shape.getOutlineThickness() != 0) {
+		stats.drawCalls++;
+		stats.vertices += (points + 1) * 2;
+	}
+}
+
+void Menu::drawObject(sf::RenderTarget& target, const sf::Text& text, const sf::RenderStates& states)
+{
+	target.draw(text, states);
+
+	// two triangles per visible glyph, drawn once more for the outline
+	std::size_t glyphs = 0;
+	for (sf::Uint32 character : text.getString()) {
+		if (character != ' ' && character != '\t' && character != '\n')
+			glyphs++;
+	}
+	if (glyphs > 0) {
+		unsigned long passes = text.getOutlineThickness() != 0 ? 2 : 1;
+		stats.drawCalls += passes;
+		stats.vertices += glyphs * 6 * passes;
+	}
+}
+
+void Menu::drawBatch(sf::RenderTarget& target, const sf::RenderStates& states)
+{
+	renderBatch.draw(target, states);
+	stats.drawCalls += renderBatch.getDrawCallCount();
+	stats.vertices += renderBatch.getVertexCount();
+}
+
+void Menu::drawStatsOverlay(sf::RenderTarget& target, const sf::RenderStates& states)
+{
+	Stats current = getStats();
+	std::ostringstream text;
+	text.precision(3);
+	text << "draw calls: " << current.drawCalls << "\n"
+		<< "vertices: " << current.vertices << "\n"
+		<< "outlines built: " << current.outlinesBuilt << "\n"
+		<< "layouts: " << current.layoutRuns << " (" << current.layoutMicroseconds / 1000 << " ms)\n"
+		<< "draw: " << current.drawMicroseconds / 1000 << " ms\n"
+		<< "items: " << current.itemBytes / 1024 << " KB\n"
+		<< "fonts: " << current.fontBytes / 1024 << " KB\n"
+		<< "geometry: " << current.geometryBytes / 1024 << " KB";
+	statsOverlay.setString(text.str());
+
+	// beside the menu, on the side facing the middle of the window. Only the caller's states are
+	// applied when drawing, so the overlay keeps its size when the menu is scaled.
+	sf::FloatRect menuArea = menuTransform.transformRect(background.getGlobalBounds());
+	const float gap = 10;
+	bool leftDocked = dockingPosition == uiTools::TOP_LEFT || dockingPosition == uiTools::BOTTOM_LEFT;
+	bool topDocked = dockingPosition == uiTools::TOP_LEFT || dockingPosition == uiTools::TOP_RIGHT;
+	uiTools::setObjectOrigin(statsOverlay, dockingPosition);
+	statsOverlay.setPosition(leftDocked ? menuArea.left + menuArea.width + gap : menuArea.left - gap,
+		topDocked ? menuArea.top : menuArea.top + menuArea.height);
+
+	target.draw(statsOverlay, states);
+}
+
+void Menu::updateRenderCache()
+{
+	// find the area covered by everything drawComponents() may draw
+	sf::FloatRect area = background.getGlobalBounds();
+	auto extendArea = [&area](const sf::FloatRect& rect) {
+		float right = std::max(area.left + area.width, rect.left + rect.width);
+		float bottom = std::max(area.top + area.height, rect.top + rect.height);
+		area.left = std::min(area.left, rect.left);
+		area.top = std::min(area.top, rect.top);
+		area.width = right - area.left;
+		area.height = bottom - area.top;
+	};
+	extendArea(outline.getGlobalBounds());
+
+	// with a viewport, items are clipped to the background
+	for (std::size_t i = visibleBegin; i < visibleEnd && viewportHeight <= 0; i++) {
+		sf::Text* item = textObjs[i];
+		extendArea(itemTransform.transformRect(item->getTransform().transformRect(measureItem(textObjSlots[i]).bounds)));
+		if (componentOutlinesShown) {
+			geometry::RoundedRectShape<>& componentOutline = getComponentOutline(textObjSlots[i]);
+			componentOutline.setPosition(item->getPosition());
+			extendArea(itemTransform.transformRect(componentOutline.getGlobalBounds()));
+		}
+	}
+
+	// align the cache to whole pixels so blitting it does not resample
+	float left = std::floor(area.left);
+	float top = std::floor(area.top);
+	unsigned int width = static_cast<unsigned int>(std::ceil(area.left + area.width - left)) + 1;
+	unsigned int height = static_cast<unsigned int>(std::ceil(area.top + area.height - top)) + 1;
+
+	// only grow the texture; a smaller menu reuses the existing one
+	sf::Vector2u textureSize = renderCache.getSize();
+	if (width > textureSize.x || height > textureSize.y) {
+		if (!renderCache.create(std::max(width, textureSize.x), std::max(height, textureSize.y))) {
+			std::cout << "ERROR: Not able to create menu render cache. Drawing uncached. (Menu::updateRenderCache())\n";
+			cacheValid = false;
+			cacheDirty = false;
+			return;
+		}
+		textureSize = renderCache.getSize();
+	}
+
+	renderCache.setView(sf::View(sf::FloatRect(left, top, static_cast<float>(textureSize.x), static_cast<float>(textureSize.y))));
+	renderCache.clear(sf::Color::Transparent);
+	drawComponents(renderCache, sf::RenderStates::Default, false);
+	renderCache.display();
+
+	cacheSprite.setTexture(renderCache.getTexture());
+	cacheSprite.setTextureRect(sf::IntRect(0, 0, static_cast<int>(width), static_cast<int>(height)));
+	cacheSprite.setPosition(left, top);
+
+	cacheValid = true;
+	cacheDirty = false;
+}
+
+void Menu::indexLabel(std::uint32_t slotIndex, const std::string& label) {
+	itemSlots[slotIndex].label = label;
+	labelIndex.emplace(std::hash<std::string_view>()(label), slotIndex);
+}
+
+void Menu::unindexLabel(std::uint32_t slotIndex) {
+	auto range = labelIndex.equal_range(std::hash<std::string_view>()(itemSlots[slotIndex].label));
+	for (auto entry = range.first; entry != range.second; ++entry) {
+		if (entry->second == slotIndex) {
+			labelIndex.erase(entry);
+			break;
+		}
+	}
+	itemSlots[slotIndex].label.clear();
+}
+
+std::uint32_t Menu::findLabel(std::string_view text) const {
+	std::uint32_t found = static_cast<std::uint32_t>(itemSlots.size());
+
+	// several items may share a label (or a hash); the first one in menu order wins
+	auto range = labelIndex.equal_range(std::hash<std::string_view>()(text));
+	for (auto entry = range.first; entry != range.second; ++entry) {
+		const ItemSlot& slot = itemSlots[entry->second];
+		if (slot.label == text && (found == itemSlots.size() || slot.orderIndex < itemSlots[found].orderIndex)) {
+			found = entry->second;
+		}
+	}
+
+	return found;
+}
+
+void Menu::trackItemWidth(std::uint32_t slotIndex) {
+	ItemSlot& slot = itemSlots[slotIndex];
+	slot.textWidth = measureItem(slotIndex).bounds.width;
+	slot.widthEntry = itemWidths.insert(slot.textWidth + slot.item->getCharacterSize() * compOutlinePadding / 2);
+}
+
+void Menu::untrackItemWidth(std::uint32_t slotIndex) {
+	ItemSlot& slot = itemSlots[slotIndex];
+	if (slot.widthEntry != itemWidths.end()) {
+		itemWidths.erase(slot.widthEntry);
+		slot.widthEntry = itemWidths.end();
+	}
+}
+
+float Menu::getWidestItemWidth() const {
+	if (itemWidths.empty()) {
+		return 0;
+	}
+
+	return *itemWidths.rbegin();
 }
\ No newline at end of file
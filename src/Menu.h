@@ -9,21 +9,72 @@
 * ------------------------------------------------------------ */
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 #include "uiTools.h"
+#include "renderBatch.h"
+#include "itemPool.h"
+#include "fontRegistry.h"
+#include "counterText.h"
+#include "textMetrics.h"
+#include "updateQueue.h"
+#include "geometry.h"
+#include "sdfFont.h"
 
 class Menu {
 
 public:
 	enum menuType { DYNAMIC, STATIC }; // #check - move outside of class?
 
+	/**
+	* Identifies a menu item. Unlike a raw sf::Text pointer, a handle can be checked after
+	* its item was removed: the slot's generation changes on removal, so stale handles are
+	* detected instead of pointing at freed memory. Default constructed handles are invalid.
+	*/
+	struct ItemHandle {
+		std::uint32_t index = 0;	//slot in itemSlots
+		std::uint32_t generation = 0;	//generation of the slot when the handle was created
+
+		bool operator==(const ItemHandle& other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const ItemHandle& other) const { return !(*this == other); }
+	};
+
+	// called by handleEvent() with the item that was hovered, clicked or focused
+	typedef std::function<void(ItemHandle)> ItemCallback;
+
+	/**
+	* Performance counters of a menu. The counters add up from the menu's creation or the
+	* last resetStats() call; the memory figures are measured when getStats() is called.
+	*/
+	struct Stats {
+		unsigned long drawCalls = 0;	//draw calls issued by draw(), including redraws of the render cache
+		unsigned long vertices = 0;	//vertices submitted with those draw calls
+		unsigned long outlinesBuilt = 0;	//component outline geometry rebuilds
+		unsigned long layoutRuns = 0;	//full layouts of the menu (layoutElements() runs)
+		double layoutMicroseconds = 0;	//time spent in full layouts
+		double drawMicroseconds = 0;	//time spent in draw()
+		std::size_t itemBytes = 0;	//approximate memory owned for menu items and their bookkeeping
+		std::size_t fontBytes = 0;	//approximate memory of the fonts in use, including their glyph textures; shared with other menus
+		std::size_t geometryBytes = 0;	//approximate memory owned for cached outlines, the render batch and render cache
+	};
+
 	sf::Text defaultTextObj;
 	sf::ConvexShape componentOutlineObj;
 
 	// ======================================================
 	// Constructors + Destructor
 	/**
-	* Default constructor for the Menu class
+	* Default constructor for the Menu class. Does not wait for the default font
+	* to load; see isFontLoaded().
 	*/
 	Menu();
 
@@ -57,12 +108,31 @@ public:
 	* Sets how much space (padding) is given between the edges of the window
 	* and the start of the menu.
 	*
+	* Items are positioned relative to the padded corner, so only the menu bounds change.
+	*
 	*   @param x - amount of horizontal space
 	*   @param y - amount of vertical space
 	*	@return true if changed succesfully
 	*/
 	bool setPadding(float x, float y);
 
+	// ------------------------------------------------------
+	/**
+	* Moves the whole menu away from its docking corner, e.g. to slide it in or out.
+	* Only the menu transform changes; no item is repositioned and a render cache stays valid.
+	*
+	*   @param offset - distance from the docked position, in pixels
+	*/
+	void setOffset(sf::Vector2f offset);
+
+	// ------------------------------------------------------
+	/**
+	* Moves the menu relative to its current offset
+	*
+	*   @param delta - distance to move, in pixels
+	*/
+	void move(sf::Vector2f delta);
+
 	// ------------------------------------------------------
 	/**
 	* Sets the spacing between menu elements and reformats existing elements
@@ -90,6 +160,171 @@ public:
 	*/
 	void setBackgroundColor(sf::Color color);
 
+	// ------------------------------------------------------
+	/**
+	* Enables or disables batched rendering. When enabled, draw() merges the menu's background,
+	* outlines and all text sharing a font texture into a few vertex arrays, so the whole
+	* menu is drawn in about 2 draw calls regardless of how many items it has.
+	* Untextured geometry (background, outlines) is drawn before all text.
+	*
+	*   @param enabled - true to draw batched, false to draw each object separately (default)
+	*/
+	void setBatchedRendering(bool enabled);
+
+	// ------------------------------------------------------
+	/**
+	* Enables or disables cached rendering. When enabled, the menu is rendered into an
+	* internal texture only when something changes (items added/removed, setters, show/hide);
+	* every other frame draw() blits that texture as a single quad. The cache holds the menu in
+	* its own coordinates, so window resizes only move the quad.
+	*
+	*   @param enabled - true to draw from the cache, false to redraw every frame (default)
+	*/
+	void setCachedRendering(bool enabled);
+
+	// ------------------------------------------------------
+	/**
+	* Enables or disables signed distance field text. When enabled, menu items are drawn from
+	* one distance field atlas per font, rasterized once at SdfFont::BASE_SIZE and sharpened
+	* by a shader, instead of from a glyph texture per character size: texture memory stays
+	* flat however many sizes the items use, and scaled menus stay sharp. Items are laid out
+	* with the atlas' glyph metrics. Text outlines are not drawn, and counter items keep
+	* their normal glyphs. Adding glyphs to an atlas reads the font's glyph page back from the
+	* GPU, so it is done when an atlas is created (printable ASCII), when items are added and
+	* when markItemDirty() (or a setter) reports a change, rather than while drawing.
+	*
+	*   @param enabled - true to draw items from distance fields, false for SFML's glyphs (default)
+	*	@return false if enabling failed because shaders are unavailable; items keep their normal glyphs
+	*/
+	bool setSdfText(bool enabled);
+
+	// ------------------------------------------------------
+	/**
+	* Marks the menu as changed so the render cache is rebuilt on the next draw().
+	* Must be called after modifying a menu item directly through its sf::Text pointer
+	* while cached rendering is enabled. If the change affects the item's size, call
+	* markItemDirty() instead.
+	*/
+	void markDirty();
+
+	// ------------------------------------------------------
+	/**
+	* Sets the font of defaultTextObj once it has loaded, without blocking. Items added from
+	* defaultTextObj in the meantime get the font when it arrives, and the menu is laid out
+	* once at that point. Use FontRegistry::loadFontAsync() to get the future.
+	*
+	*   @param font - future holding the font
+	*	@return true if changed succesfully
+	*/
+	bool setDefaultFont(FontRegistry::FontFuture font);
+
+	// ------------------------------------------------------
+	/**
+	* Rasterizes glyphs of defaultTextObj's font (in its style and outline) ahead of time,
+	* so the first frame showing new strings or sizes does not stall. Waits for the font
+	* if it is still loading. See FontRegistry::prewarm().
+	*
+	*   @param characters - which characters to rasterize, e.g. FontRegistry::PRINTABLE_ASCII
+	*	@param characterSizes - sizes to rasterize at; defaultTextObj's character size if empty
+	*	@return bytes of texture memory the new glyphs took
+	*/
+	std::size_t prewarmGlyphs(const sf::String& characters, const std::vector<unsigned int>& characterSizes = {});
+
+	// ------------------------------------------------------
+	/**
+	* Turns the menu into a scrollable list with a fixed visible height. Items outside the
+	* visible area are clipped (through an sf::View) and are not positioned, measured or drawn,
+	* so a frame costs the same for 100 items as for 100,000. Note that items outside the
+	* visible area are only positioned once they scroll into view.
+	*
+	*   @param height - height of the visible part of the item list; 0 turns scrolling off (default)
+	*	@return true if changed succesfully
+	*/
+	bool setViewportHeight(float height);
+
+	// ------------------------------------------------------
+	/**
+	* Sets every counter in the menu's stats back to zero. Call once per frame
+	* to get per-frame numbers from getStats().
+	*/
+	void resetStats();
+
+	// ------------------------------------------------------
+	/**
+	* Scrolls the item list. An offset of 0 shows the items closest to the docking corner.
+	* Scrolling moves the view rather than the items, so it does not lay out the menu again.
+	*
+	*   @param offset - distance to scroll away from the docking corner; clamped to the list length
+	*	@return true if changed succesfully
+	*/
+	bool setScrollOffset(float offset);
+
+	// ------------------------------------------------------
+	/**
+	* Scrolls the item list relative to its current offset
+	*
+	*   @param delta - distance to scroll; positive values scroll away from the docking corner
+	*/
+	void scrollBy(float delta);
+
+	// ======================================================
+	// Accessors
+	/**
+	* Gets the menu's version counter, which increases every time something that affects
+	* how the menu is drawn changes. Comparing it with the value from the previous
+	* frame tells whether the menu changed this frame.
+	*
+	*	@return the current version
+	*/
+	unsigned long getVersion() const;
+
+	// ------------------------------------------------------
+	/**
+	*	@return the menu's distance from its docked position
+	*/
+	sf::Vector2f getOffset() const;
+
+	// ------------------------------------------------------
+	/**
+	* Gets the transform from item coordinates to window coordinates. Menu items are
+	* positioned relative to the menu's padded corner, so the window bounds of an item are
+	* getTransform().transformRect(item->getGlobalBounds()).
+	*
+	*	@return sf::Transform - the item-to-window transform
+	*/
+	sf::Transform getTransform() const;
+
+	// ------------------------------------------------------
+	/**
+	* Checks whether the font set for defaultTextObj has finished loading. Menus load the
+	* default font on a worker thread and draw nothing until they have a font.
+	*
+	*	@return true if no font is loading
+	*/
+	bool isFontLoaded() const;
+
+	// ------------------------------------------------------
+	/**
+	*	@return how far the item list is scrolled away from the docking corner
+	*/
+	float getScrollOffset() const;
+
+	// ------------------------------------------------------
+	/**
+	*	@return the largest scroll offset; 0 if every item fits in the viewport
+	*/
+	float getMaxScrollOffset() const;
+
+	// ------------------------------------------------------
+	/**
+	* Gets the menu's performance counters and measures how much memory it owns.
+	* Counting is always on and costs a few additions per draw call; measuring
+	* memory walks every item, so it is done only here.
+	*
+	*	@return the counters since the last resetStats() and the current memory use
+	*/
+	Stats getStats() const;
+
 	// ======================================================
 	// Appearance
 	/**
@@ -145,35 +380,95 @@ public:
 	*/
 	void toggleComponentOutlines();
 
+	// ------------------------------------------------------
+	/**
+	* Causes the menu's stats (see getStats()) to be drawn next to it as part of Menu::draw(),
+	* with the same render states, while the menu is shown
+	*/
+	void showStatsOverlay();
+
+	// ------------------------------------------------------
+	/**
+	* Stops the menu's stats from being drawn in Menu::draw()
+	*/
+	void hideStatsOverlay();
+
+	// ------------------------------------------------------
+	/**
+	* Toggles the stats overlay on/off
+	*/
+	void toggleStatsOverlay();
+
 	// ======================================================
 	// Miscallaneous
 	/**
 	* Adds new menu item relative to other existing items. Currently only supported for sf::Text objects.
 	* Creates new sf::Text object and stores it in textObjs[], will re-use font objects if possible
 	*
-	*   @param win - a reference to the window object
+	*   @param target - the window or texture the menu is drawn to; the menu docks to its corners
 	*	@param text - what string should the text object hold
 	*	@param textObj - the text object (template) to use to add the menu item; uses defaultTextObj by default
 	*	@return pointer to added object if added sucessfully. Otherwise returns a NULL pointer
 	*/
-	sf::Text* addMenuItem(sf::RenderWindow& win, const std::string text, const sf::Text* textObj = nullptr);
+	sf::Text* addMenuItem(sf::RenderTarget& target, const std::string text, const sf::Text* textObj = nullptr);
+
+	// ------------------------------------------------------
+	/**
+	* Adds many menu items at once, laying the menu out a single time at the end instead of
+	* once per item. Accepts any range of strings, string_views or C strings; strings are
+	* moved from when the range is an rvalue.
+	*
+	*   @param target - the window or texture the menu is drawn to; the menu docks to its corners
+	*	@param texts - the strings of the items to add, in order
+	*	@param textObj - the text object (template) to use for every item; uses defaultTextObj by default
+	*	@return number of items added
+	*/
+	template <typename Range>
+	std::size_t addMenuItems(sf::RenderTarget& target, Range&& texts, const sf::Text* textObj = nullptr);
+
+	std::size_t addMenuItems(sf::RenderTarget& target, std::initializer_list<std::string_view> texts, const sf::Text* textObj = nullptr)
+	{
+		return addMenuItems<std::initializer_list<std::string_view>&>(target, texts, textObj);
+	}
+
+	// ------------------------------------------------------
+	/**
+	* Starts a batch of changes. Until the matching commitUpdate(), adding and removing items
+	* and the layout setters (padding, component buffer, docking, ...) only record that the
+	* menu needs laying out; commitUpdate() then lays it out once. Calls may be nested.
+	* draw() called in between keeps the last committed layout.
+	*/
+	void beginUpdate();
+
+	// ------------------------------------------------------
+	/**
+	* Ends a batch of changes started with beginUpdate(). The outermost call lays out the
+	* menu if anything in the batch required it.
+	*
+	*	@return true if ended succesfully; false if there was no batch to end
+	*/
+	bool commitUpdate();
 
 	// ------------------------------------------------------
 	/**
-	* Looks for a menu item in textObjs[] with a matching string field.
-	* Returns a pointer to the first object that matches these descriptions
+	* Looks for a menu item with a matching string field.
+	* Returns a pointer to the first object that matches these descriptions.
+	* Uses a hash index of item strings, so lookups are O(1) and do not allocate. The index
+	* tracks strings set through addMenuItem()/addItem() and setItemText(); strings changed
+	* directly through an item's sf::Text pointer are not seen by it.
 	*
 	*   @param text - the string of the object we wish to find
 	*	@return pointer to the object if found; if not return nullptr
 	*/
-	sf::Text* findMenuItem(const std::string text);
+	sf::Text* findMenuItem(std::string_view text);
 
 	// ------------------------------------------------------
 	/**
 	* Removes an item from the menu. Gets a pointer to the object to remove and deletes
 	* it from textObjs[] and frees up allocated memory. Important: if a pointer to this
 	* item was saved in addMenuItem(), it should be set to null, to prevent trying
-	* to access memory it can't access anymore.
+	* to access memory it can't access anymore. Items added with addItem() can be removed
+	* through their handle with removeItem() instead, which detects stale references.
 	*
 	*   @param objToRemove - a pointer to the object to remove
 	*	@return true if deletion was succesful
@@ -198,13 +493,227 @@ public:
 
 	// ------------------------------------------------------
 	/**
-	* Draws all menu items to the window - only function that must be called EVERY frame.
+	* Same as addMenuItem(), but returns a handle to the added item instead of a pointer
+	*
+	*   @param target - the window or texture the menu is drawn to; the menu docks to its corners
+	*	@param text - what string should the text object hold
+	*	@param textObj - the text object (template) to use to add the menu item; uses defaultTextObj by default
+	*	@return handle to the added item; invalid if the item could not be added
+	*/
+	ItemHandle addItem(sf::RenderTarget& target, const std::string text, const sf::Text* textObj = nullptr);
+
+	// ------------------------------------------------------
+	/**
+	* Adds a counter item: a label followed by a number, e.g. "Score: 20". Digits are drawn in
+	* cells of equal width, so the item only changes width (and the menu only realigns) when the
+	* number gains or loses a character. Counters are drawn from their own glyph quads, of which
+	* setCounterValue() rewrites only the changed digits; they stay out of the render cache so
+	* value changes do not redraw it. The template's outline, underline and strike through are
+	* not drawn for counters.
+	*
+	*   @param target - the window or texture the menu is drawn to; the menu docks to its corners
+	*	@param label - text shown before the number; findItem() finds the counter by it
+	*	@param value - the number to show
+	*	@param textObj - the text object (template) to use for the item; uses defaultTextObj by default
+	*	@return handle to the added item; invalid if the item could not be added
+	*/
+	ItemHandle addCounter(sf::RenderTarget& target, const std::string& label, long long value, const sf::Text* textObj = nullptr);
+
+	// ------------------------------------------------------
+	/**
+	* Changes the number a counter item shows. Costs nothing if the formatted number is
+	* unchanged, and next to nothing while its length stays the same.
+	*
+	*   @param handle - handle to a counter item
+	*	@param value - the number to show
+	*	@return true if set; false if the handle was stale, invalid or not a counter
+	*/
+	bool setCounterValue(ItemHandle handle, long long value);
+
+	// ------------------------------------------------------
+	/**
+	* Removes the item a handle refers to in O(1). The gap the item leaves is closed
+	* and the menu re-laid out once, on the next draw().
+	*
+	*   @param handle - handle to the item to remove
+	*	@return true if removed; false if the handle was stale or invalid
+	*/
+	bool removeItem(ItemHandle handle);
+
+	// ------------------------------------------------------
+	/**
+	* Gets the item a handle refers to
+	*
+	*   @param handle - handle to the item
+	*	@return pointer to the item, or nullptr if the handle is stale or invalid
+	*/
+	sf::Text* getItem(ItemHandle handle);
+
+	// ------------------------------------------------------
+	/**
+	* Checks if a handle still refers to an item in this menu
+	*
+	*   @param handle - the handle to check
+	*	@return true if the item has not been removed
+	*/
+	bool isValid(ItemHandle handle) const;
+
+	// ------------------------------------------------------
+	/**
+	* Changes the string of the item a handle refers to
+	*
+	*   @param handle - handle to the item
+	*	@param text - the new string
+	*	@return true if changed; false if the handle was stale or invalid
+	*/
+	bool setItemText(ItemHandle handle, const std::string text);
+
+	// ------------------------------------------------------
+	/**
+	* Changes the text style (sf::Text::Bold, Italic, ...) of the item a handle refers to
+	*
+	*   @param handle - handle to the item
+	*	@param style - the new style
+	*	@return true if changed; false if the handle was stale or invalid
+	*/
+	bool setItemStyle(ItemHandle handle, sf::Uint32 style);
+
+	// ------------------------------------------------------
+	/**
+	* Changes the character size of the item a handle refers to. Moves the items after it,
+	* so the menu is laid out again on the next draw().
+	*
+	*   @param handle - handle to the item
+	*	@param size - the new character size
+	*	@return true if changed; false if the handle was stale or invalid
+	*/
+	bool setItemCharacterSize(ItemHandle handle, unsigned int size);
+
+	// ------------------------------------------------------
+	/**
+	* Tells the menu an item was changed through its sf::Text pointer in a way that may change
+	* its size (string, style, character size, font, ...). The item is measured and realigned on
+	* the next draw(); draw() does not check items that were not marked. With distance field
+	* text, glyphs the item now needs are added to the atlas right away.
+	*
+	*   @param handle - handle to the item
+	*	@return true if marked; false if the handle was stale or invalid
+	*/
+	bool markItemDirty(ItemHandle handle);
+
+	// ------------------------------------------------------
+	/**
+	* Thread-safe versions of the item setters, for game logic running on another thread than
+	* the one drawing the menu. They take no lock and never touch the item: the change is queued
+	* and applied at the start of the next draw(). Each call allocates one queue node with new,
+	* so they are only as non-blocking as the allocator. If an item gets several changes of the same
+	* kind before then, only the last one is applied. Changes to items removed in the meantime
+	* are dropped. These are the only Menu functions that may be called while draw() runs; get
+	* the handles on the drawing thread (from addItem()/findItem()) and pass them along.
+	*
+	*   @param handle - handle to the item
+	*	@param text, style, size, color - the new value
+	*/
+	void queueItemText(ItemHandle handle, std::string text);
+	void queueItemStyle(ItemHandle handle, sf::Uint32 style);
+	void queueItemCharacterSize(ItemHandle handle, unsigned int size);
+	void queueItemFillColor(ItemHandle handle, sf::Color color);
+	void queueCounterValue(ItemHandle handle, long long value);
+
+	// ------------------------------------------------------
+	/**
+	* Same as findMenuItem(), but returns a handle to the item
+	*
+	*   @param text - the string of the item we wish to find
+	*	@return handle to the first matching item; invalid if there is none
+	*/
+	ItemHandle findItem(std::string_view text);
+
+	// ------------------------------------------------------
+	/**
+	* Lets the menu react to window events:
+	*   - Resized re-anchors the menu to the window's new corner by moving one menu-level
+	*     transform; no item is touched. draw() also notices size changes on its own.
+	*   - MouseMoved/MouseLeft update the hovered item, MouseButtonPressed (left) focuses and
+	*     clicks the item under the cursor.
+	*   - Up/Down move the keyboard focus (scrolling it into view), Enter/Space click the focused item.
+	* Mouse positions are mapped the way the menu was last drawn to a window, or, until it is
+	* drawn to one, to whatever target it was last drawn to (e.g. an offscreen texture shown
+	* by other means, with events forwarded in that texture's pixels). Finding the item
+	* under the cursor is a binary search over the item rows; hover and focus changes only
+	* move the highlight and never lay out the menu or redraw its render cache.
+	*
+	*   @param event - an event polled from the window the menu is drawn to
+	*	@return true if the menu used the event (the cursor is over an item, a click hit an item, focus moved)
+	*/
+	bool handleEvent(const sf::Event& event);
+
+	// ------------------------------------------------------
+	/**
+	* Sets the functions handleEvent() calls when the hovered item changes, when an item is clicked
+	* (or activated with Enter/Space) and when the keyboard focus moves. The hover and focus
+	* callbacks receive an invalid handle when no item is hovered or focused any more.
+	*
+	*   @param callback - the function to call; an empty function removes the callback
+	*/
+	void setHoverCallback(ItemCallback callback);
+	void setClickCallback(ItemCallback callback);
+	void setFocusCallback(ItemCallback callback);
+
+	// ------------------------------------------------------
+	/**
+	* Moves the keyboard focus to an item, scrolling it into view. Calls the focus callback.
+	*
+	*   @param handle - the item to focus; an invalid handle clears the focus
+	*	@return true if changed; false if the handle was stale
+	*/
+	bool setFocusedItem(ItemHandle handle);
+
+	// ------------------------------------------------------
+	/**
+	*	@return the item under the mouse cursor; invalid if there is none
+	*/
+	ItemHandle getHoveredItem() const;
+
+	// ------------------------------------------------------
+	/**
+	*	@return the item with the keyboard focus; invalid if there is none
+	*/
+	ItemHandle getFocusedItem() const;
+
+	// ------------------------------------------------------
+	/**
+	* Finds the item whose row contains a point, with a binary search over the item rows.
+	* Rows span the menu's width and include the space between items.
+	*
+	*   @param point - the point, in the coordinates of the window the menu was last drawn to
+	*	@return handle to the item; invalid if the point is outside every item (or the menu awaits layout)
+	*/
+	ItemHandle getItemAt(sf::Vector2f point);
+
+	// ------------------------------------------------------
+	/**
+	* Sets the color of the highlight drawn behind the hovered (or else the focused) item.
+	* With cached rendering it is drawn over the item instead, since the cache holds the items.
+	*
+	*   @param color - the highlight color; sf::Color::Transparent hides the highlight
+	*/
+	void setHighlightColor(sf::Color color);
+
+	// ------------------------------------------------------
+	/**
+	* Draws all menu items to a render target - only function that must be called EVERY frame.
 	* Also does some basic reformatting of objects in the menu
-	* so that they all remain within the bounds of the window.
+	* so that they all remain within the bounds of the target.
+	* The menu can be drawn to several targets of different sizes in the same frame (split
+	* screen views, minimap textures, captures); it docks to each target's corner and
+	* reuses its layout and, with cached rendering, its render cache for all of them.
 	*
-	*   @param win - the window on which well draw the menu components
+	*   @param target - the window or texture on which we'll draw the menu components
+	*   @param states - extra render states, e.g. a transform that scales the menu down for a minimap.
+	*		Their blend mode also applies to the cache blit, adjusted for the cache's premultiplied colors.
 	*/
-	void draw(sf::RenderWindow& win);
+	void draw(sf::RenderTarget& target, const sf::RenderStates& states = sf::RenderStates::Default);
 
 private:
 	// ------------------------------------------------------
@@ -218,8 +727,7 @@ private:
 	const float DEFAULT_COMP_OUTLINE_PADDING = 1;	//percentage relative to component height
 
 	// misc
-	const std::string BACKUP_FONT_NAME = "arial.ttf"; // used for creating backupFontObj
-	// NOTE: To change deafult font: must also change constructors
+	// NOTE: To change deafult font: must also change FontRegistry::getDefaultFont()
 
 	// ------------------------------------------------------
 	// Variables
@@ -228,6 +736,13 @@ private:
 	bool menuShown;	//when enabled, menu is drawn every frame to the window (false by default)
 	bool componentOutlinesShown;	//when enabled, draws outlines around UI elements to the screen
 	bool menuBoundsShown;	//draws an outline around the whole menu
+	bool statsOverlayShown;	//draws the menu's stats next to it
+	bool batchedRendering;	//when enabled, draw() submits the menu through renderBatch
+	bool sdfText;	//when enabled, items are drawn from sdfFonts
+	bool cachedRendering;	//when enabled, draw() blits renderCache instead of redrawing the menu
+	bool cacheDirty;	//if true, renderCache is redrawn on the next draw()
+	bool cacheValid;	//false until renderCache has been drawn succesfully
+	unsigned long version;	//increased by markDirty()
 
 	// formatting
 	uiTools::cornerType dockingPosition;	//where to start drawing elements relative to the window
@@ -238,19 +753,122 @@ private:
 	int componentBuffer;	//space between menu components
 	float compOutlinePadding;	//space between menu components and their outline objects
 	int numElements;	//number of total menu items
-	bool mustReformatElements;	//if true, menu items are reformatted at start of draw()
+	bool mustReformatElements;	//if true, layoutElements() is run at start of draw() (unless a beginUpdate() batch is open)
+	int updateDepth;	//number of beginUpdate() calls without a commitUpdate(); layout is deferred while above 0
+	float viewportHeight;	//height of the visible part of the item list; 0 when scrolling is off
+	float scrollOffset;	//distance the item list is scrolled away from the docking corner
+	unsigned long layoutCount;	//increased whenever item positions change; see ItemSlot::placedLayout
 
-	std::unordered_map<std::string, sf::Font*> fonts;
-	sf::Font* backupFontObj;	//used when user doesn't specify what font to use
+	std::vector<std::shared_ptr<sf::Font>> fonts;	//every font given to defaultTextObj, shared with other menus through FontRegistry
+	std::shared_ptr<sf::Font> backupFontObj;	//used when user doesn't specify what font to use; null until loaded
+	FontRegistry::FontFuture pendingFont;	//font for defaultTextObj still being loaded; invalid when there is none
 
 	sf::RectangleShape background; //the object for drawing the menu's background
 	sf::RectangleShape outline;	//the object for drawing the bounds of the menu
+	RenderBatch renderBatch;	//merged geometry of the whole menu, rebuilt each draw() when batching
+	// distance field atlas of one font, and how many items are drawn from it
+	struct SdfAtlas {
+		std::unique_ptr<SdfFont> font;
+		std::size_t items = 0;	//the atlas is dropped when this returns to 0, before the font could be freed and its address reused
+	};
+	// prewarmGlyphs() may leave an atlas with no items, but only for a font the menu loaded and keeps in 'fonts'
+	std::unordered_map<const sf::Font*, SdfAtlas> sdfFonts;	//atlas of each item font, while sdfText is on
+	sf::VertexArray sdfVertices = sf::VertexArray(sf::Triangles);	//quads of the item drawSdfText() is drawing
+	sf::RenderTexture renderCache;	//the menu as last drawn, used by cached rendering
+	sf::Sprite cacheSprite;	//the part of renderCache holding the menu, positioned in the window
+	sf::Vector2u cachedWindowSize;	//size of the target the menu was last anchored in
+	sf::Transform menuTransform;	//moves the menu from its own coordinates (outer corner at 0,0) to its window corner
+	sf::Transform itemTransform;	//moves items from item coordinates (inner corner at 0,0) to menu coordinates
+	sf::Vector2f offset;	//distance of the menu from its docked position
+	sf::Text statsOverlay;	//text of the stats overlay
+
+	// performance counters
+	Stats stats;	//counters only; memory figures are filled in by getStats()
 
 	// misc
 	sf::Color backgroundColor;	//set to transparent by default
 
 	// object arrays for storing and pulling UI elements
-	sf::Text* textObjs[30];
+	ItemPool<sf::Text> itemPool;	//owns every menu item; addresses stay valid until the item is removed
+	std::vector<sf::Text*> textObjs;	//menu items in the order they were added; nullptr where an item was removed
+	std::vector<std::uint32_t> textObjSlots;	//itemSlots index of each entry in textObjs
+	std::vector<float> itemOffsets;	//distance from the top of the first item to the top of each item in textObjs
+	std::size_t visibleBegin;	//textObjs range drawn by the current draw()
+	std::size_t visibleEnd;
+
+	// slot referenced by an ItemHandle
+	struct ItemSlot {
+		sf::Text* item;	//nullptr while the slot is free
+		std::uint32_t generation;	//increased whenever the slot's item is removed
+		std::size_t orderIndex;	//position of the item in textObjs
+		std::string label;	//string the item was given through the Menu; key in labelIndex
+		float textWidth;	//width of the item's text when it was last measured
+		std::multiset<float>::iterator widthEntry;	//the item's entry in itemWidths
+		unsigned long placedLayout;	//layoutCount when the item was last positioned
+		bool awaitingFont;	//added from defaultTextObj while pendingFont was loading
+		bool dirty;	//in dirtyItems, waiting to be measured again
+		unsigned int characterSize;	//character size the item was laid out with
+		std::unique_ptr<CounterText> counter;	//number drawn in place of the item's text for counter items; nullptr otherwise
+		RenderBatch::Range counterRange;	//where the counter's quads are in counterBatch
+		sf::Transform counterTransform;	//transform they were added to counterBatch with
+		const sf::Font* atlasFont;	//font whose entry in sdfFonts counts this item; nullptr if none
+	};
+	std::vector<ItemSlot> itemSlots;
+	std::vector<std::uint32_t> freeSlots;	//itemSlots indices available for reuse
+	std::vector<std::uint32_t> dirtyItems;	//itemSlots indices of items changed since the last draw()
+	std::vector<std::uint32_t> counterSlots;	//itemSlots indices of counter items, in no particular order
+	RenderBatch counterBatch;	//quads of the counters drawn when batching; kept between draws so only changed digits are rewritten
+	std::vector<std::uint32_t> batchedCounters;	//itemSlots indices of the counters in counterBatch, in batch order
+	std::vector<std::uint32_t> frameCounters;	//itemSlots indices of the counters drawCounter() was given since the last drawCounterBatch()
+
+	// input
+	ItemHandle hoveredItem;	//item under the mouse cursor
+	ItemHandle focusedItem;	//item with the keyboard focus
+	ItemCallback hoverCallback;
+	ItemCallback clickCallback;
+	ItemCallback focusCallback;
+	bool inputMapped;	//true once the menu was drawn, so mouse positions can be mapped
+	bool inputFromWindow;	//true if the mapping comes from a window; other targets then no longer replace it
+	sf::View inputView;	//view of the mapped target during its last draw
+	sf::IntRect inputViewport;	//its viewport, in pixels
+	sf::Transform inputTransform;	//transform from menu to target coordinates used for that draw
+	sf::RectangleShape highlight;	//drawn behind the hovered or focused item, in item coordinates
+
+	// an item change made by one of the queueItem...() functions
+	struct QueuedUpdate {
+		enum Field { TEXT, STYLE, CHARACTER_SIZE, FILL_COLOR, COUNTER_VALUE };
+		ItemHandle handle;
+		Field field;
+		std::string text;	//new string of a TEXT change
+		sf::Uint32 value;	//new style, character size or color (as an integer) of a STYLE, CHARACTER_SIZE or FILL_COLOR change
+		long long number;	//new value of a COUNTER_VALUE change
+	};
+	UpdateQueue<QueuedUpdate> updateQueue;	//changes from other threads, waiting for the next draw()
+	std::vector<std::uint8_t> appliedFields;	//per itemSlots index, bit per Field already applied by applyQueuedUpdates()
+	std::vector<std::uint32_t> updatedSlots;	//itemSlots indices with bits set in appliedFields
+	std::vector<QueuedUpdate> survivingUpdates;	//changes applyQueuedUpdates() kept, newest first
+	std::unordered_multimap<std::size_t, std::uint32_t> labelIndex;	//hash of an item's label -> its itemSlots index
+	std::multiset<float> itemWidths;	//width each item needs (text plus outline padding), largest last
+	std::size_t holeCount;	//number of nullptr entries in textObjs waiting for compactItems()
+	std::size_t firstItemIndex;	//textObjs index of the first item; entries before it are holes
+	TextMetricsCache textMetrics;	//item sizes for layout, so items are not asked for their bounds
+
+	// component outline geometry cache
+	/**
+	* Rounded rect built for a single menu item, along with the item properties
+	* it was built from. Rebuilt only when one of these properties changes.
+	*/
+	struct OutlineCacheEntry {
+		geometry::RoundedRectShape<> shape;	//sized and origined for the item; only its position changes per frame
+		sf::String string;	//item string the shape was built for
+		unsigned int characterSize;	//item character size the shape was built for
+		const sf::Font* font;	//item font the shape was built for
+		sf::Uint32 style;	//item text style the shape was built for
+	};
+	std::unordered_map<const sf::Text*, OutlineCacheEntry> outlineCache;
+	sf::Color cachedOutlineFillColor;	//componentOutlineObj style the cache was built with
+	float cachedOutlineThickness;
+	sf::Color cachedOutlineColor;
 
 	// ------------------------------------------------------
 	// Functions
@@ -270,6 +888,21 @@ private:
 	*/
 	sf::Vector2f getInnerCorner(sf::Vector2f outerCorner);
 
+	// ------------------------------------------------------
+	/**
+	* Anchors the menu in a target of the given size. Does nothing if the size has not changed.
+	*
+	*   @param windowSize - size of the window or texture the menu is drawn to
+	*/
+	void anchorTo(sf::Vector2u windowSize);
+
+	// ------------------------------------------------------
+	/**
+	* Rebuilds menuTransform from the docking corner of the anchoring window and the offset,
+	* and itemTransform from the padding
+	*/
+	void updateTransform();
+
 	// ------------------------------------------------------
 	/**
 	* Sets the menu's bounds and resizes its outline object
@@ -281,88 +914,375 @@ private:
 
 	// ------------------------------------------------------
 	/**
-	* Important: INEFFICIENT. Reformats elements within the menu by deleting
-	* each menu item and readding it then formatting the menu again.
-	* Essentially "recreates" the menu
+	* Lays out the whole menu in place: recalculates every item's origin and position
+	* and the menu bounds in one pass over the items, without allocating. Used whenever
+	* a change affects more than the item being added (docking, component
+	* buffer, outline padding, removals, bottom docked additions).
+	* With a viewport, only itemOffsets and the bounds are recalculated; items are
+	* positioned by placeItem() when they scroll into view.
+	*/
+	void layoutElements();
+
+	// ------------------------------------------------------
+	/**
+	* Lays the menu out now, or marks it for layout if layout is deferred (inside
+	* beginUpdate()/commitUpdate() or while the font is loading)
+	*/
+	void requestLayout();
+
+	// ------------------------------------------------------
+	/**
+	* Makes room for more items in the arrays that index them
+	*
+	*   @param count - number of items about to be added
+	*/
+	void reserveItems(std::size_t count);
+
+	// ------------------------------------------------------
+	/**
+	* Closes the holes removeItem() leaves in textObjs in one pass, keeping item order.
+	* Called by layoutElements(), so holes never survive a draw().
+	*/
+	void compactItems();
+
+	// ------------------------------------------------------
+	/**
+	* Applies the changes queued by other threads, keeping only the last change of each kind
+	* per item, in the order they were queued. Called at the start of draw().
+	*/
+	void applyQueuedUpdates();
+
+	// ------------------------------------------------------
+	/**
+	* Applies pendingFont once it has loaded: gives it to defaultTextObj and to the items
+	* waiting for it, measures those items and schedules a single layout
+	*/
+	void resolvePendingFont();
+
+	// ------------------------------------------------------
+	/**
+	* Measures and realigns the items in dirtyItems and updates the menu width. Schedules a
+	* layout if one of them changed character size, since that moves the following items.
+	*/
+	void updateDirtyItems();
+
+	// ------------------------------------------------------
+	/**
+	* Sets an item's origin and position from its entry in itemOffsets
 	*
-	*   @param win - a reference to the window object
+	*   @param index - position of the item in textObjs
 	*/
-	void reformatElements(sf::RenderWindow& win);
+	void placeItem(std::size_t index);
 
 	// ------------------------------------------------------
 	/**
-	* Reorders an array of objects to "fill in any holes" that were
-	* created by deleting items from the array. Where this function finds
-	* a nullptr (hole), all following items are moved back by 1 spot.
+	* Finds the items that intersect the viewport (with a binary search over itemOffsets)
+	* and stores them in visibleBegin/visibleEnd. Without a viewport every item is visible.
+	*/
+	void updateVisibleRange();
+
+	// ------------------------------------------------------
+	/**
+	* Gets the y coordinate of the top of the first item, before scrolling
 	*
-	*   @param array - the array to reformat
-	*	@param len - the length of the array
+	*	@return float - the y coordinate in item space
 	*/
-	void reformatArray(sf::Text* array[], int len);
+	float getContentTop();
 
 	// ------------------------------------------------------
 	/**
-	* Gets the index of the last non-null entry in the textObjs array
+	* Gets how far the scroll offset moves the view over the items. The item list grows
+	* away from the docking corner, so the view moves down for top docks and up for bottom docks.
 	*
-	*   @return int - the index of the sf::Text object in textObjs[]
+	*	@return float - vertical distance between the menu area and the part of the items shown in it
 	*/
-	int getLastIndex();
+	float getScrollShift() const;
 
 	// ------------------------------------------------------
 	/**
-	* Loops over the textObjs array and finds the index of the widest item.
-	* If there is a tie, simply returns the index of one of these objects.
+	* Builds the view that clips items to the menu's background and applies the scroll offset
 	*
-	*	@return int - the index of the item
+	*   @param target - the target the items are drawn to; its current view maps the menu to pixels
+	*	@param transform - transform the menu is drawn with
+	*	@return sf::View - view to draw the items with
 	*/
-	int getWidestItemIndex();
+	sf::View getClipView(const sf::RenderTarget& target, const sf::Transform& transform) const;
+
+	// ------------------------------------------------------
+	/**
+	* Builds a handle to the item at a position in textObjs
+	*
+	*   @param index - position of the item in textObjs
+	*	@return ItemHandle - handle to the item
+	*/
+	ItemHandle makeHandle(std::size_t index) const;
 
 	// ------------------------------------------------------
-	// Helper Functions
 	/**
-	* Reformats existing elements to use new padding; called in setPadding()
+	* Sets the label of an item slot and adds it to labelIndex
 	*
-	*   @param diffPaddingX - the change in horizontal padding
-	*   @param diffPadingY - the change in vertical padding
+	*   @param slotIndex - the itemSlots index of the item
+	*	@param label - the item's string
 	*/
-	void applyPaddingDiff(float diffPaddingX, float diffPaddingY);
+	void indexLabel(std::uint32_t slotIndex, const std::string& label);
 
 	// ------------------------------------------------------
 	/**
-	* Reformats existing elements to use the new component buffer; called in setCompBuffer()
+	* Removes an item slot's label from labelIndex
 	*
-	*   @param diff - the new value versus the old one
+	*   @param slotIndex - the itemSlots index of the item
 	*/
-	void applyCompBufferDiff(int diff);
+	void unindexLabel(std::uint32_t slotIndex);
 
+	// ------------------------------------------------------
+	/**
+	* Finds the first item (in menu order) whose label matches
+	*
+	*   @param text - the label to look for
+	*	@return the itemSlots index of the item, or itemSlots.size() if there is none
+	*/
+	std::uint32_t findLabel(std::string_view text) const;
+
+	// ------------------------------------------------------
+	/**
+	* Measures an item's text and adds the width it needs to itemWidths
+	*
+	*   @param slotIndex - the itemSlots index of the item
+	*/
+	void trackItemWidth(std::uint32_t slotIndex);
+
+	// ------------------------------------------------------
+	/**
+	* Removes an item's entry from itemWidths
+	*
+	*   @param slotIndex - the itemSlots index of the item
+	*/
+	void untrackItemWidth(std::uint32_t slotIndex);
+
+	// ------------------------------------------------------
+	/**
+	* Gets the width the widest item needs, not counting menu padding
+	*
+	*	@return float - the width, or 0 if the menu has no items
+	*/
+	float getWidestItemWidth() const;
+
+	// ------------------------------------------------------
+	/**
+	* Sets an item's origin from its cached measurement (see uiTools::setObjectOrigin())
+	*
+	*   @param slotIndex - the item's index in itemSlots
+	*	@param originPoint - which corner the origin should be set at
+	*/
+	void setItemOrigin(std::uint32_t slotIndex, uiTools::cornerType originPoint);
+
+	// ------------------------------------------------------
+	/**
+	* Measures an item with the glyphs it is drawn with: its font's, or the distance field
+	* atlas' when sdfText is on and the item is not a counter
+	*
+	*   @param slotIndex - the item's index in itemSlots
+	*	@return TextMetrics - the item's advance and ink bounds
+	*/
+	TextMetrics measureItem(std::uint32_t slotIndex);
+
+	// ------------------------------------------------------
+	/**
+	* Gets the distance field atlas an item is drawn from
+	*
+	*   @param slotIndex - the item's index in itemSlots
+	*	@return the atlas, or nullptr if the item is drawn with its font's glyphs (sdfText off, or a counter)
+	*/
+	SdfFont* getItemSdfFont(std::uint32_t slotIndex);
+
+	/**
+	* Stops counting an item towards the atlas of its font, dropping the atlas if no item is left
+	*   @param slotIndex - the item's index in itemSlots
+	*/
+	void releaseItemAtlas(std::uint32_t slotIndex);
+
+	// ------------------------------------------------------
+	/**
+	* Gets the distance field atlas of a font, creating it on first use with the printable
+	* ASCII glyphs already in it
+	*
+	*   @param font - the font
+	*	@return the atlas, or nullptr if sdfText is off or there is no font
+	*/
+	SdfFont* getSdfFont(const sf::Font* font);
+
+	// ------------------------------------------------------
+	/**
+	* Gets the index of the last entry in textObjs. Removals keep the last entry a live item.
+	*
+	*   @return int - the index of the sf::Text object in textObjs[]
+	*/
+	int getLastIndex();
+
+	// ------------------------------------------------------
+	// Helper Functions
 	/**
 	* Helper for addMenuItem(). Adds a new text object to the textObjs array. 
 	* Calls default constructor and does not change any of the new item's properties.
 	*   @param objToUse - the text object to be added.
 	*   @param index - reference to the index where the text object is added.
-	*   @return pointer to the added text object or nullptr if the array is full.
+	*   @return pointer to the added text object.
 	*/
 	sf::Text* addTextObj(const sf::Text& objToUse, int& index);
 
 	/**
 	* Helper for addMenuItem(). Calculates the position of the text object based on the last element added.
 	*   @param lastElementAdded - pointer to the last added text object or nullptr if there is no previous element.
-	*   @param win - Reference to the RenderWindow object.
 	*   @return sf::Vector2f containing the calculated position of the text object.
 	*/
-	sf::Vector2f calculateTextObjPosition(sf::Text* lastElementAdded, const sf::RenderWindow& win);
+	sf::Vector2f calculateTextObjPosition(sf::Text* lastElementAdded);
 
 	/**
-	* Helper for addMenuItem(). Moves previous elements up by one "space" when 
-	* dockingPosition is BOTTOM_LEFT or BOTTOM_RIGHT.
-	*   @param index - the index of the current added text object in the textObjs array.
-	*   @param win - reference to the RenderWindow object.
+	* Helper for addMenuItem(). Updates the menu bounds based on the added item, which must
+	* already be in itemWidths. O(log n): the menu width comes from the widest tracked item.
+	*   @param addedItemHeight - character size of the recently added text object.
 	*/
-	void movePreviousElements(int index, const sf::RenderWindow& win);
+	void updateBounds(int addedItemHeight);
 
 	/**
-	* Helper for addMenuItem(). Updates the menu bounds based on the added item.
-	*   @param addedItem - pointer to the recently added text object.
+	* Helper for draw(). Gets the cached component outline for a menu item, rebuilding it
+	* only if the item's string, character size, font or style changed since it was cached.
+	*   @param slotIndex - index in itemSlots of the menu item to get the outline for
+	*   @return reference to the cached outline shape
 	*/
-	void updateBounds(const sf::Text* addedItem, int addedItemHeight);
-};
\ No newline at end of file
+	geometry::RoundedRectShape<>& getComponentOutline(std::uint32_t slotIndex);
+
+	/**
+	* Helper for draw(). Draws the background, menu items and outline to a render target,
+	* either object by object or through renderBatch.
+	*   @param target - the window or texture to draw to
+	*   @param states - render states holding the transform from menu to target coordinates
+	*   @param includeLive - false to leave out what changes without invalidating the render
+	*   cache (the highlight and counter items), when filling the cache
+	*/
+	void drawComponents(sf::RenderTarget& target, const sf::RenderStates& states, bool includeLive = true);
+
+	/**
+	* Helper for draw(). Draws the highlight and the visible counter items on top of the render
+	* cache, which leaves them out so hovering and counter values do not redraw it.
+	*   @param target - the window or texture to draw to
+	*   @param states - render states holding the transform from menu to target coordinates
+	*/
+	void drawOverCache(sf::RenderTarget& target, const sf::RenderStates& states);
+
+	/**
+	* Moves the highlight to the hovered (or else focused) item and draws it, or adds it to
+	* renderBatch when batching. The shape is only changed when the item or its row moved.
+	*   @param states - render states holding the transform from item to target coordinates
+	*/
+	void drawHighlight(sf::RenderTarget& target, const sf::RenderStates& states);
+
+	/**
+	* Gets the row an item takes up in item coordinates: the menu's width by the item's height
+	* plus the space to the next item
+	*   @param index - position of the item in textObjs
+	*/
+	sf::FloatRect getItemRow(std::size_t index);
+
+	/**
+	* Changes hoveredItem and calls the hover callback if it is a different item
+	*/
+	void setHoveredItem(ItemHandle handle);
+
+	/**
+	* Moves the keyboard focus to the next or previous item
+	*   @param step - 1 for the next item, -1 for the previous one
+	*	@return true if the focus moved
+	*/
+	bool moveFocus(int step);
+
+	/**
+	* Scrolls the viewport (if any) so an item is entirely shown
+	*   @param index - position of the item in textObjs
+	*/
+	void scrollIntoView(std::size_t index);
+
+	/**
+	* Draws one counter item's glyph quads, or queues it for drawCounterBatch() when batching
+	*   @param slotIndex - the counter item's index in itemSlots
+	*   @param states - render states holding the transform from item to target coordinates
+	*/
+	void drawCounter(sf::RenderTarget& target, std::uint32_t slotIndex, const sf::RenderStates& states);
+
+	/**
+	* Draws the counters queued by drawCounter() from counterBatch. The batch is only rebuilt
+	* when the set of counters, their order, transforms or glyph textures changed; otherwise
+	* just the vertices of digits that changed are copied into it.
+	*   @param states - render states the menu is drawn with
+	*/
+	void drawCounterBatch(sf::RenderTarget& target, const sf::RenderStates& states);
+
+	/**
+	* Draws one item from its font's distance field atlas, or adds it to renderBatch when batching
+	*   @param item - the menu item
+	*   @param sdfFont - the atlas of the item's font
+	*   @param states - render states holding the transform from item to target coordinates
+	*/
+	void drawSdfText(sf::RenderTarget& target, const sf::Text& item, SdfFont& sdfFont, const sf::RenderStates& states);
+
+	/**
+	* Turns a counter item back into a plain text item
+	*   @param slotIndex - the item's index in itemSlots
+	*/
+	void removeCounter(std::uint32_t slotIndex);
+
+	/**
+	* Helpers for drawComponents(). Draw an object or the render batch and count
+	* the draw calls and vertices it takes the way SFML submits them.
+	*   @param target - the window or texture to draw to
+	*/
+	void drawObject(sf::RenderTarget& target, const sf::Shape& shape, const sf::RenderStates& states);
+	void drawObject(sf::RenderTarget& target, const sf::Text& text, const sf::RenderStates& states);
+	void drawBatch(sf::RenderTarget& target, const sf::RenderStates& states);
+
+	/**
+	* Helper for draw(). Updates and draws the stats overlay next to the menu.
+	*   @param target - the window or texture the menu is drawn to
+	*   @param states - render states draw() was called with (before the menu's own transform)
+	*/
+	void drawStatsOverlay(sf::RenderTarget& target, const sf::RenderStates& states);
+
+	/**
+	* Helper for draw(). Redraws the menu into renderCache, growing it if the menu no longer fits,
+	* and points cacheSprite at the result. Both are in menu coordinates.
+	*/
+	void updateRenderCache();
+
+	/**
+	* Discards all cached component outlines so they are rebuilt on the next draw.
+	* Called when docking, compOutlinePadding or componentOutlineObj's style changes.
+	*/
+	void clearOutlineCache();
+};
+
+// ======================================================
+// Template definitions
+template <typename Range>
+std::size_t Menu::addMenuItems(sf::RenderTarget& target, Range&& texts, const sf::Text* textObj)
+{
+	typedef decltype(std::begin(texts)) Iterator;
+	if constexpr (std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>::value) {
+		reserveItems(static_cast<std::size_t>(std::distance(std::begin(texts), std::end(texts))));
+	}
+
+	std::size_t added = 0;
+	beginUpdate();
+	for (auto&& text : texts) {
+		sf::Text* item;
+		if constexpr (std::is_lvalue_reference<Range>::value)
+			item = addMenuItem(target, std::string(text), textObj);
+		else
+			item = addMenuItem(target, std::string(std::move(text)), textObj);
+
+		if (item)
+			added++;
+	}
+	commitUpdate();
+
+	return added;
+}
\ No newline at end of file
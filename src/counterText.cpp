@@ -0,0 +1,222 @@
+/** --------------------------------------------------------
+* @file    counterText.cpp
+* @author  Luke Wagner
+* @version 1.0
+*
+* CounterText class implementation
+*   The label is laid out the way SFML 2.5 lays out sf::Text; the value is laid out
+*	in fixed cells after it
+*
+* ------------------------------------------------------------ */
+#include "counterText.h"
+
+#include <algorithm>
+#include <charconv>
+
+namespace {
+	bool isDigit(char character) {
+		return character >= '0' && character <= '9';
+	}
+}
+
+CounterText::valueChange CounterText::setValue(long long value)
+{
+	char formatted[MAX_CHARACTERS];
+	std::to_chars_result result = std::to_chars(formatted, formatted + MAX_CHARACTERS, value);
+	std::size_t count = static_cast<std::size_t>(result.ptr - formatted);
+
+	if (count == digitCount && std::equal(formatted, formatted + count, digits)) {
+		return UNCHANGED;
+	}
+
+	valueChange change = count == digitCount ? DIGITS_CHANGED : LENGTH_CHANGED;
+	std::copy(formatted, formatted + count, digits);
+	digitCount = count;
+	return change;
+}
+
+std::string_view CounterText::getDigits() const
+{
+	return std::string_view(digits, digitCount);
+}
+
+std::string CounterText::getLayoutString(const std::string& label) const
+{
+	std::string layout = label;
+	for (std::size_t i = 0; i < digitCount; i++) {
+		layout += isDigit(digits[i]) ? '0' : digits[i];
+	}
+	return layout;
+}
+
+const sf::VertexArray& CounterText::update(const sf::Text& item)
+{
+	changedBegin = changedEnd = 0;
+	if (!item.getFont()) {
+		vertices.clear();
+		font = nullptr;
+		return vertices;
+	}
+
+	if (item.getFont() != font || item.getCharacterSize() != characterSize || item.getStyle() != style ||
+		item.getFillColor() != color || item.getLetterSpacing() != letterSpacingFactor || digitCount != drawnCount) {
+		rebuild(item);
+		return vertices;
+	}
+
+	for (std::size_t i = 0; i < digitCount; i++) {
+		if (digits[i] != drawnDigits[i]) {
+			if (!isDigit(digits[i]) || !isDigit(drawnDigits[i])) {
+				// the sign moved; the cells after it move too
+				rebuild(item);
+				return vertices;
+			}
+			writeCell(i);
+			drawnDigits[i] = digits[i];
+			if (changedBegin == changedEnd)
+				changedBegin = digitVertexStart + i * 6;
+			changedEnd = digitVertexStart + (i + 1) * 6;
+		}
+	}
+
+	return vertices;
+}
+
+std::pair<std::size_t, std::size_t> CounterText::getChangedVertices() const
+{
+	return { changedBegin, changedEnd };
+}
+
+const sf::Texture* CounterText::getTexture() const
+{
+	return font ? &font->getTexture(characterSize) : nullptr;
+}
+
+std::size_t CounterText::getMemoryUsage() const
+{
+	return sizeof(CounterText) + vertices.getVertexCount() * sizeof(sf::Vertex);
+}
+
+void CounterText::rebuild(const sf::Text& item)
+{
+	font = item.getFont();
+	characterSize = item.getCharacterSize();
+	style = item.getStyle();
+	color = item.getFillColor();
+	letterSpacingFactor = item.getLetterSpacing();
+
+	bool isBold = style & sf::Text::Bold;
+	italicShear = (style & sf::Text::Italic) ? 0.209f : 0.f; // 12 degrees in radians
+	float whitespaceWidth = font->getGlyph(L' ', characterSize, isBold).advance;
+	float letterSpacing = (whitespaceWidth / 3.f) * (letterSpacingFactor - 1.f);
+	whitespaceWidth += letterSpacing;
+	float lineSpacing = font->getLineSpacing(characterSize) * item.getLineSpacing();
+
+	// label: everything in the item's string before the value
+	const sf::String& string = item.getString();
+	std::size_t labelLength = string.getSize() > digitCount ? string.getSize() - digitCount : 0;
+
+	vertices.clear();
+	float x = 0.f;
+	float y = static_cast<float>(characterSize);
+	sf::Uint32 prevChar = 0;
+	for (std::size_t i = 0; i < labelLength; i++) {
+		sf::Uint32 curChar = string[i];
+		if (curChar == L'\r')
+			continue;
+
+		x += font->getKerning(prevChar, curChar, characterSize);
+		prevChar = curChar;
+
+		// whitespace only advances the pen
+		if (curChar == L' ' || curChar == L'\n' || curChar == L'\t') {
+			switch (curChar) {
+			case L' ':
+				x += whitespaceWidth;
+				break;
+			case L'\t':
+				x += whitespaceWidth * 4;
+				break;
+			case L'\n':
+				y += lineSpacing;
+				x = 0;
+				break;
+			}
+			continue;
+		}
+
+		const sf::Glyph& glyph = font->getGlyph(curChar, characterSize, isBold);
+		std::size_t first = vertices.getVertexCount();
+		vertices.resize(first + 6);
+		setGlyphQuad(&vertices[first], sf::Vector2f(x, y), glyph);
+		x += glyph.advance + letterSpacing;
+	}
+
+	// value: digits get cells as wide as the widest digit, so the width does not depend on the value
+	cellWidth = 0;
+	for (char digit = '0'; digit <= '9'; digit++) {
+		cellWidth = std::max(cellWidth, font->getGlyph(static_cast<sf::Uint32>(digit), characterSize, isBold).advance);
+	}
+
+	// kerning follows the layout string (digits as '0'), so the cells line up with the measured width
+	for (std::size_t i = 0; i < digitCount; i++) {
+		sf::Uint32 layoutChar = isDigit(digits[i]) ? L'0' : static_cast<sf::Uint32>(digits[i]);
+		x += font->getKerning(prevChar, layoutChar, characterSize);
+		prevChar = layoutChar;
+
+		cellLeft[i] = x;
+		x += (isDigit(digits[i]) ? cellWidth : font->getGlyph(layoutChar, characterSize, isBold).advance) + letterSpacing;
+	}
+	numberBaseline = y;
+
+	digitVertexStart = vertices.getVertexCount();
+	vertices.resize(digitVertexStart + digitCount * 6);
+	for (std::size_t i = 0; i < digitCount; i++) {
+		writeCell(i);
+		drawnDigits[i] = digits[i];
+	}
+	drawnCount = digitCount;
+	changedBegin = 0;
+	changedEnd = vertices.getVertexCount();
+}
+
+void CounterText::writeCell(std::size_t index)
+{
+	char character = digits[index];
+	const sf::Glyph& glyph = font->getGlyph(static_cast<sf::Uint32>(character), characterSize, (style & sf::Text::Bold) != 0);
+
+	// digits are centered in their cell
+	float x = cellLeft[index];
+	if (isDigit(character)) {
+		x += (cellWidth - glyph.advance) / 2;
+	}
+
+	setGlyphQuad(&vertices[digitVertexStart + index * 6], sf::Vector2f(x, numberBaseline), glyph);
+}
+
+void CounterText::setGlyphQuad(sf::Vertex* quad, sf::Vector2f position, const sf::Glyph& glyph) const
+{
+	float padding = 1.0;
+
+	float left = glyph.bounds.left - padding;
+	float top = glyph.bounds.top - padding;
+	float right = glyph.bounds.left + glyph.bounds.width + padding;
+	float bottom = glyph.bounds.top + glyph.bounds.height + padding;
+
+	float u1 = static_cast<float>(glyph.textureRect.left) - padding;
+	float v1 = static_cast<float>(glyph.textureRect.top) - padding;
+	float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+	float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+	sf::Vector2f topLeft(position.x + left - italicShear * top, position.y + top);
+	sf::Vector2f topRight(position.x + right - italicShear * top, position.y + top);
+	sf::Vector2f bottomLeft(position.x + left - italicShear * bottom, position.y + bottom);
+	sf::Vector2f bottomRight(position.x + right - italicShear * bottom, position.y + bottom);
+
+	quad[0] = sf::Vertex(topLeft, color, sf::Vector2f(u1, v1));
+	quad[1] = sf::Vertex(topRight, color, sf::Vector2f(u2, v1));
+	quad[2] = sf::Vertex(bottomLeft, color, sf::Vector2f(u1, v2));
+	quad[3] = sf::Vertex(bottomLeft, color, sf::Vector2f(u1, v2));
+	quad[4] = sf::Vertex(topRight, color, sf::Vector2f(u2, v1));
+	quad[5] = sf::Vertex(bottomRight, color, sf::Vector2f(u2, v2));
+}
@@ -0,0 +1,126 @@
+/** --------------------------------------------------------
+* @file    counterText.h
+* @author  Luke Wagner
+* @version 1.0
+*
+* CounterText class definition
+*   Glyph quads of a "label + number" menu item (score, FPS, ammo, ...). The number is
+*	formatted with std::to_chars into a fixed buffer and drawn with tabular digits (every
+*	digit in a cell as wide as the widest one), so the item keeps its width while the
+*	value changes and only the quads of digits that changed are rewritten
+*
+* ------------------------------------------------------------ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <SFML/Graphics.hpp>
+
+class CounterText {
+
+public:
+	// what setValue() changed
+	enum valueChange { UNCHANGED, DIGITS_CHANGED, LENGTH_CHANGED };
+
+	// ======================================================
+	// Value
+	/**
+	* Formats a new value. Nothing else is done until the quads are next requested.
+	*
+	*   @param value - the number to show
+	*	@return LENGTH_CHANGED if the number now has a different number of characters (the
+	*		item's width changes), DIGITS_CHANGED if only digits changed, otherwise UNCHANGED
+	*/
+	valueChange setValue(long long value);
+
+	// ------------------------------------------------------
+	/**
+	*	@return the characters of the current value
+	*/
+	std::string_view getDigits() const;
+
+	// ------------------------------------------------------
+	/**
+	* Gets the string a menu lays the item out with: the label followed by the value with
+	* every digit replaced by '0'. Every value with as many characters has the same layout.
+	*
+	*   @param label - the text shown before the number
+	*	@return std::string - the layout string
+	*/
+	std::string getLayoutString(const std::string& label) const;
+
+	// ======================================================
+	// Geometry
+	/**
+	* Brings the glyph quads up to date and returns them. They are rebuilt when the item's
+	* font, character size, style, fill color or letter spacing changed or the value changed
+	* length; otherwise only the quads of changed digits are rewritten. The item's outline,
+	* underline and strike through are not drawn.
+	*
+	*   @param item - the menu item the counter draws; its string must be the layout string
+	*	@return the quads as triangles, in the item's local coordinates
+	*/
+	const sf::VertexArray& update(const sf::Text& item);
+
+	// ------------------------------------------------------
+	/**
+	*	@return the range [first, second) of vertices the last update() rewrote; every vertex
+	*		if it rebuilt them, an empty range if nothing changed
+	*/
+	std::pair<std::size_t, std::size_t> getChangedVertices() const;
+
+	// ------------------------------------------------------
+	/**
+	*	@return the glyph texture the quads use; nullptr before the first update() with a font
+	*/
+	const sf::Texture* getTexture() const;
+
+	// ------------------------------------------------------
+	/**
+	*	@return approximate number of bytes the counter owns
+	*/
+	std::size_t getMemoryUsage() const;
+
+private:
+	static const std::size_t MAX_CHARACTERS = 24;	//fits any long long
+
+	char digits[MAX_CHARACTERS] = { '0' };	//current value, not null terminated
+	std::size_t digitCount = 1;
+	char drawnDigits[MAX_CHARACTERS] = {};	//value the quads show
+	std::size_t drawnCount = 0;
+	float cellLeft[MAX_CHARACTERS] = {};	//x of each character's cell
+
+	// what the quads were built with
+	const sf::Font* font = nullptr;
+	unsigned int characterSize = 0;
+	sf::Uint32 style = 0;
+	sf::Color color;
+	float letterSpacingFactor = 1;
+	float cellWidth = 0;	//advance of the widest digit
+	float italicShear = 0;
+	float numberBaseline = 0;	//y of the line the value is on
+
+	sf::VertexArray vertices = sf::VertexArray(sf::Triangles);
+	std::size_t digitVertexStart = 0;	//vertices before this index belong to the label
+	std::size_t changedBegin = 0;	//vertices rewritten by the last update()
+	std::size_t changedEnd = 0;
+
+	// ------------------------------------------------------
+	// Helper Functions
+	/**
+	* Rebuilds every quad: the label's as sf::Text lays them out, then one cell per character of the value
+	*/
+	void rebuild(const sf::Text& item);
+
+	/**
+	* Rewrites the quad of one character of the value
+	*/
+	void writeCell(std::size_t index);
+
+	/**
+	* Writes one glyph as two triangles at quad[0..5]; same layout as sf::Text
+	*/
+	void setGlyphQuad(sf::Vertex* quad, sf::Vector2f position, const sf::Glyph& glyph) const;
+};
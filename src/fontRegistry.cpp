@@ -0,0 +1,223 @@
+/** --------------------------------------------------------
+* @file    fontRegistry.cpp
+* @author  Luke Wagner
+* @version 1.0
+*
+* FontRegistry class implementation
+*   Fonts are held through weak pointers, so the registry never keeps a font alive
+*	on its own. A font being parsed is listed in loading, so it is never parsed twice
+*	and the lock is not held while FreeType works.
+*
+* ------------------------------------------------------------ */
+#include "fontRegistry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include "fonts.h"
+
+const sf::String FontRegistry::PRINTABLE_ASCII = " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
+const sf::String FontRegistry::DIGITS = "0123456789";
+std::atomic<unsigned long> FontRegistry::freedFonts{ 0 };
+
+FontRegistry& FontRegistry::instance()
+{
+	static FontRegistry registry;
+	return registry;
+}
+
+std::shared_ptr<sf::Font> FontRegistry::getFont(const std::string& filename)
+{
+	return findOrLoad("file:" + filename, [&filename](sf::Font& font) {
+		return font.loadFromFile(filename);
+	});
+}
+
+std::shared_ptr<sf::Font> FontRegistry::getFont(const std::string& name, const void* data, std::size_t size)
+{
+	return findOrLoad("memory:" + name, [data, size](sf::Font& font) {
+		return font.loadFromMemory(data, size);
+	});
+}
+
+std::shared_ptr<sf::Font> FontRegistry::getDefaultFont()
+{
+	return getFont("arial.ttf", fonts::arial, fonts::arial_len);
+}
+
+FontRegistry::FontFuture FontRegistry::loadFontAsync(const std::string& filename)
+{
+	return startAsyncLoad("file:" + filename, [filename](sf::Font& font) {
+		return font.loadFromFile(filename);
+	});
+}
+
+FontRegistry::FontFuture FontRegistry::loadFontAsync(const std::string& name, const void* data, std::size_t size)
+{
+	return startAsyncLoad("memory:" + name, [data, size](sf::Font& font) {
+		return font.loadFromMemory(data, size);
+	});
+}
+
+FontRegistry::FontFuture FontRegistry::loadDefaultFontAsync()
+{
+	return loadFontAsync("arial.ttf", fonts::arial, fonts::arial_len);
+}
+
+std::size_t FontRegistry::prewarm(const sf::Font& font, const sf::String& characters,
+	const std::vector<unsigned int>& characterSizes, bool bold, float outlineThickness)
+{
+	std::size_t bytes = 0;
+	for (unsigned int characterSize : characterSizes) {
+		// each character size has its own glyph texture, which only ever grows. Asking for it creates
+		// it if nothing used this size yet, and a page created here counts from zero.
+		const sf::Texture& page = font.getTexture(characterSize);
+		sf::Vector2u before = holdsGlyphs(page) ? page.getSize() : sf::Vector2u(0, 0);
+
+		for (sf::Uint32 character : characters) {
+			font.getGlyph(character, characterSize, bold);
+			if (outlineThickness != 0) {
+				font.getGlyph(character, characterSize, bold, outlineThickness);
+			}
+		}
+
+		sf::Vector2u after = font.getTexture(characterSize).getSize();
+		bytes += (static_cast<std::size_t>(after.x) * after.y - static_cast<std::size_t>(before.x) * before.y) * 4;
+	}
+
+	return bytes;
+}
+
+bool FontRegistry::holdsGlyphs(const sf::Texture& page)
+{
+	// a page starts at 128x128 and only grows once its first rows are full
+	sf::Vector2u size = page.getSize();
+	if (size.x != 128 || size.y != 128) {
+		return true;
+	}
+
+	sf::Image image = page.copyToImage();
+	const sf::Uint8* pixels = image.getPixelsPtr();
+	for (unsigned int y = 0; y < size.y; y++) {
+		for (unsigned int x = 0; x < size.x; x++) {
+			// skip the 2x2 white square every page reserves for underlines
+			if ((x >= 2 || y >= 2) && pixels[(y * size.x + x) * 4 + 3] != 0) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+std::size_t FontRegistry::size()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	removeExpired();
+	return fonts.size();
+}
+
+unsigned long FontRegistry::getFreedFontCount()
+{
+	return freedFonts.load(std::memory_order_acquire);
+}
+
+template <typename LoadFn>
+std::shared_ptr<sf::Font> FontRegistry::findOrLoad(const std::string& key, LoadFn&& load)
+{
+	std::promise<std::shared_ptr<sf::Font>> loaded;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		auto found = fonts.find(key);
+		if (found != fonts.end()) {
+			if (std::shared_ptr<sf::Font> font = found->second.lock()) {
+				return font;
+			}
+		}
+
+		// another thread is parsing this font; wait for its result
+		auto pending = loading.find(key);
+		if (pending != loading.end()) {
+			FontFuture result = pending->second;
+			lock.unlock();
+			return result.get();
+		}
+
+		loading[key] = loaded.get_future().share();
+	}
+
+	std::shared_ptr<sf::Font> font = finishLoad(key, load);
+	loaded.set_value(font);
+	return font;
+}
+
+template <typename LoadFn>
+std::shared_ptr<sf::Font> FontRegistry::finishLoad(const std::string& key, LoadFn&& load)
+{
+	std::shared_ptr<sf::Font> font(new sf::Font(), [](sf::Font* freed) {
+		delete freed;
+		freedFonts.fetch_add(1, std::memory_order_release);
+	});
+	if (!load(*font)) {
+		std::cout << "ERROR: Error loading font " << key << " (FontRegistry::getFont())\n";
+		font = nullptr;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (font) {
+			removeExpired();
+			fonts[key] = font;
+		}
+		loading.erase(key);
+	}
+
+	return font;
+}
+
+template <typename LoadFn>
+FontRegistry::FontFuture FontRegistry::startAsyncLoad(const std::string& key, LoadFn load)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto found = fonts.find(key);
+	if (found != fonts.end()) {
+		if (std::shared_ptr<sf::Font> font = found->second.lock()) {
+			std::promise<std::shared_ptr<sf::Font>> ready;
+			ready.set_value(font);
+			return ready.get_future().share();
+		}
+	}
+
+	// already being parsed, by a worker or a getFont() call; share its result
+	auto pending = loading.find(key);
+	if (pending != loading.end()) {
+		return pending->second;
+	}
+
+	auto loaded = std::make_shared<std::promise<std::shared_ptr<sf::Font>>>();
+	FontFuture result = loaded->get_future().share();
+	loading[key] = result;
+
+	// forget workers that are done
+	asyncLoads.erase(std::remove_if(asyncLoads.begin(), asyncLoads.end(), [](const std::future<void>& worker) {
+		return worker.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	}), asyncLoads.end());
+
+	// the worker lets go of the promise once it has handed the font over, so a finished
+	// worker never keeps a font alive; only the futures of whoever asked for it do
+	asyncLoads.push_back(std::async(std::launch::async, [this, key, load, loaded]() mutable {
+		std::shared_ptr<std::promise<std::shared_ptr<sf::Font>>> promise = std::move(loaded);
+		promise->set_value(finishLoad(key, load));
+	}));
+	return result;
+}
+
+void FontRegistry::removeExpired()
+{
+	for (auto entry = fonts.begin(); entry != fonts.end();) {
+		if (entry->second.expired())
+			entry = fonts.erase(entry);
+		else
+			++entry;
+	}
+}
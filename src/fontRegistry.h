@@ -0,0 +1,197 @@
+/** --------------------------------------------------------
+* @file    fontRegistry.h
+* @author  Luke Wagner
+* @version 1.0
+*
+* FontRegistry class definition
+*   Process-wide cache of loaded fonts. Every Menu asking for the same font gets the
+*	same sf::Font object, so the font is parsed once and its glyph textures (one per
+*	character size) are shared. A font is freed when the last Menu using it is destroyed.
+*
+* ------------------------------------------------------------ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+class FontRegistry {
+
+public:
+	// result of an asynchronous load; holds nullptr if the font could not be loaded
+	typedef std::shared_future<std::shared_ptr<sf::Font>> FontFuture;
+
+	// character sets for prewarm()
+	static const sf::String PRINTABLE_ASCII;	//space through '~'
+	static const sf::String DIGITS;	//'0' through '9'
+
+	// ======================================================
+	// Access
+	/**
+	* Gets the registry shared by the whole process
+	*
+	*	@return reference to the registry
+	*/
+	static FontRegistry& instance();
+
+	// ------------------------------------------------------
+	/**
+	* Gets a font loaded from a file, loading it if no one holds it yet.
+	* Safe to call from several threads.
+	*
+	*   @param filename - path of the font file; also identifies the font in the registry
+	*	@return the shared font, or nullptr if it could not be loaded
+	*/
+	std::shared_ptr<sf::Font> getFont(const std::string& filename);
+
+	// ------------------------------------------------------
+	/**
+	* Gets a font loaded from memory, loading it if no one holds it yet. The data
+	* is not copied and must stay valid as long as the font is in use.
+	* Safe to call from several threads.
+	*
+	*   @param name - identifies the font in the registry
+	*	@param data - the font file's contents
+	*	@param size - size of data in bytes
+	*	@return the shared font, or nullptr if it could not be loaded
+	*/
+	std::shared_ptr<sf::Font> getFont(const std::string& name, const void* data, std::size_t size);
+
+	// ------------------------------------------------------
+	/**
+	* Gets the embedded default font (arial)
+	*
+	*	@return the shared font, or nullptr if it could not be loaded
+	*/
+	std::shared_ptr<sf::Font> getDefaultFont();
+
+	// ------------------------------------------------------
+	/**
+	* Same as getFont(), but parses the font on a worker thread and returns right away.
+	* Glyph textures are still created on the thread that first draws with the font.
+	*
+	*   @param filename - path of the font file
+	*	@return future holding the shared font; already ready if the font was loaded, and
+	*		shared with the load already running if another caller is loading it
+	*/
+	FontFuture loadFontAsync(const std::string& filename);
+
+	// ------------------------------------------------------
+	/**
+	* Same as getFont() from memory, but parses the font on a worker thread
+	*
+	*   @param name - identifies the font in the registry
+	*	@param data - the font file's contents
+	*	@param size - size of data in bytes
+	*	@return future holding the shared font; already ready if the font was loaded
+	*/
+	FontFuture loadFontAsync(const std::string& name, const void* data, std::size_t size);
+
+	// ------------------------------------------------------
+	/**
+	* Same as getDefaultFont(), but parses the font on a worker thread
+	*
+	*	@return future holding the shared font; already ready if the font was loaded
+	*/
+	FontFuture loadDefaultFontAsync();
+
+	// ------------------------------------------------------
+	/**
+	* Rasterizes glyphs into a font's glyph textures ahead of time, so the first frame
+	* showing them does not. Touches OpenGL textures, so like drawing it must run on the
+	* thread that draws, not on a loading thread.
+	*
+	*   @param font - the font to rasterize glyphs of
+	*	@param characters - which characters to rasterize, e.g. PRINTABLE_ASCII or a locale's alphabet
+	*	@param characterSizes - the character sizes to rasterize each character at
+	*	@param bold - rasterize the bold variants
+	*	@param outlineThickness - also rasterize outlined variants of this thickness if not 0
+	*	@return bytes of texture memory the new glyphs took (growth of the glyph textures,
+	*	        including textures created for character sizes not used before)
+	*/
+	static std::size_t prewarm(const sf::Font& font, const sf::String& characters,
+		const std::vector<unsigned int>& characterSizes, bool bold = false, float outlineThickness = 0);
+
+	// ------------------------------------------------------
+	/**
+	*	@return number of fonts currently loaded and in use
+	*/
+	std::size_t size();
+
+	// ------------------------------------------------------
+	/**
+	* Gets how many registry fonts have been freed so far. A new font may be allocated at a freed
+	* one's address, so anything keyed by sf::Font pointers must be dropped when this changes.
+	* Safe to call from any thread, including during static destruction.
+	*
+	*	@return number of fonts freed since the program started
+	*/
+	static unsigned long getFreedFontCount();
+
+private:
+	FontRegistry() = default;
+	FontRegistry(const FontRegistry&) = delete;
+	FontRegistry& operator=(const FontRegistry&) = delete;
+
+	std::mutex mutex;	//guards fonts, loading and asyncLoads
+	std::unordered_map<std::string, std::weak_ptr<sf::Font>> fonts;	//source key -> font; expires when no one holds it
+	std::unordered_map<std::string, FontFuture> loading;	//fonts being parsed (or queued on a worker) right now; later requests share these
+	std::vector<std::future<void>> asyncLoads;	//worker threads, kept so callers dropping their future never block on it; they hold no font
+	static std::atomic<unsigned long> freedFonts;	//increased by the deleter of every registry font
+
+	// ------------------------------------------------------
+	// Helper Functions
+	/**
+	* Looks up a font, waits for it if another thread is loading it, or loads and registers it.
+	* Must be called with mutex unlocked; the font is parsed without holding the lock.
+	*
+	*   @param key - the font's source key
+	*	@param load - loads the font into a new sf::Font; returns false on failure
+	*	@return the shared font, or nullptr if it could not be loaded
+	*/
+	template <typename LoadFn>
+	std::shared_ptr<sf::Font> findOrLoad(const std::string& key, LoadFn&& load);
+
+	/**
+	* Returns a ready future if the font is loaded, the pending future if it is being loaded,
+	* otherwise lists it in loading and starts a worker thread that parses it
+	*
+	*   @param key - the font's source key
+	*	@param load - loads the font into a new sf::Font; returns false on failure
+	*	@return future holding the shared font
+	*/
+	template <typename LoadFn>
+	FontFuture startAsyncLoad(const std::string& key, LoadFn load);
+
+	/**
+	* Parses a font already listed in loading, registers it and takes it out of loading.
+	* Must be called with mutex unlocked.
+	*
+	*   @param key - the font's source key
+	*	@param load - loads the font into a new sf::Font; returns false on failure
+	*	@return the shared font, or nullptr if it could not be loaded
+	*/
+	template <typename LoadFn>
+	std::shared_ptr<sf::Font> finishLoad(const std::string& key, LoadFn&& load);
+
+	/**
+	* Drops the entries of fonts no one holds anymore. Must be called with mutex locked.
+	*/
+	void removeExpired();
+
+	/**
+	* Tells whether a glyph page holds any glyph. sf::Font has no way to ask whether a page
+	* exists without creating it, so prewarm() touches the page and then checks that it is
+	* not blank. Reads the texture back only while it still has its starting size.
+	*
+	*   @param page - glyph texture of one character size
+	*	@return false if the page is as sf::Font creates it, with only the underline square
+	*/
+	static bool holdsGlyphs(const sf::Texture& page);
+};
@@ -0,0 +1,266 @@
+/** --------------------------------------------------------
+* @file    geometry.h
+* @author  Luke Wagner
+* @version 1.0
+*
+* Rounded rectangle geometry kernels
+*   Unit quarter circle tables are computed at compile time for each number of points
+*	per corner, so building a rounded rectangle is a few multiply-adds per point: no
+*	sin/cos, no square roots and no heap allocation. Provides the corner points, an
+*	sf::Shape built from them, and functions that write a rounded rectangle's fill and
+*	outline triangles straight into a caller supplied vertex buffer for batching.
+*
+* ------------------------------------------------------------ */
+#pragma once
+
+#include <cstddef>
+#include <SFML/Graphics.hpp>
+
+namespace geometry {
+	// ======================================================
+	// Compile-time trigonometry
+	constexpr double PI = 3.14159265358979323846;
+
+	/**
+	* sin(x) from its Taylor series. Exact to double precision for |x| <= pi/2,
+	* the only range the tables below use.
+	*/
+	constexpr double taylorSin(double x) {
+		double term = x;
+		double sum = x;
+		for (int n = 1; n < 14; n++) {
+			term *= -x * x / ((2.0 * n) * (2.0 * n + 1));
+			sum += term;
+		}
+		return sum;
+	}
+
+	/**
+	* cos(x) from its Taylor series. Exact to double precision for |x| <= pi/2.
+	*/
+	constexpr double taylorCos(double x) {
+		double term = 1;
+		double sum = 1;
+		for (int n = 1; n < 14; n++) {
+			term *= -x * x / ((2.0 * n - 1) * (2.0 * n));
+			sum += term;
+		}
+		return sum;
+	}
+
+	// ======================================================
+	// Unit arc tables
+	/**
+	* A quarter circle of radius 1 from angle 0 to pi/2, sampled at PointsPerCorner evenly
+	* spaced angles, with the outline offset (miter) of each point. The miters are what
+	* sf::Shape computes from the two edges meeting at a point, so outlines built from the
+	* table match SFML's without any square roots.
+	*/
+	template <unsigned int PointsPerCorner>
+	struct UnitArc {
+		static_assert(PointsPerCorner >= 2, "a rounded corner needs at least two points");
+
+		float x[PointsPerCorner];	//cos of each point's angle
+		float y[PointsPerCorner];	//sin of each point's angle
+		float miterX[PointsPerCorner];	//outline offset of each point per unit of outline thickness
+		float miterY[PointsPerCorner];
+	};
+
+	template <unsigned int PointsPerCorner>
+	constexpr UnitArc<PointsPerCorner> makeUnitArc() {
+		UnitArc<PointsPerCorner> arc{};
+		const double step = PI / (2 * (PointsPerCorner - 1));
+		for (unsigned int j = 0; j < PointsPerCorner; j++) {
+			double angle = j * step;
+			arc.x[j] = static_cast<float>(taylorCos(angle));
+			arc.y[j] = static_cast<float>(taylorSin(angle));
+
+			// the edges meeting at the point are straight sides at the ends of the arc
+			double before = j == 0 ? 0 : angle - step / 2;
+			double after = j == PointsPerCorner - 1 ? PI / 2 : angle + step / 2;
+			double middle = (before + after) / 2;
+			double scale = 1 / taylorCos((after - before) / 2);
+			arc.miterX[j] = static_cast<float>(taylorCos(middle) * scale);
+			arc.miterY[j] = static_cast<float>(taylorSin(middle) * scale);
+		}
+		return arc;
+	}
+
+	template <unsigned int PointsPerCorner>
+	inline constexpr UnitArc<PointsPerCorner> unitArc = makeUnitArc<PointsPerCorner>();
+
+	// ======================================================
+	// Rounded rectangles
+	/**
+	*	@return number of points of a rounded rectangle
+	*/
+	template <unsigned int PointsPerCorner>
+	constexpr std::size_t roundedRectPointCount() {
+		return 4 * PointsPerCorner;
+	}
+
+	/**
+	*	@return number of vertices emitRoundedRect() writes: three per fill triangle, plus six per outline quad
+	*/
+	template <unsigned int PointsPerCorner>
+	constexpr std::size_t roundedRectVertexCount(bool outlined) {
+		return roundedRectPointCount<PointsPerCorner>() * (outlined ? 9 : 3);
+	}
+
+	/**
+	* Calls fn(point, miter) for every point of a rounded rectangle, in the same order as
+	* createRoundedRect(): counter-clockwise from the bottom right corner's right side
+	*
+	*   @param size - width and height of the rectangle
+	*	@param radius - radius of the corners
+	*	@param fn - receives each point and its outline offset per unit of outline thickness
+	*/
+	template <unsigned int PointsPerCorner, typename Fn>
+	void forEachRoundedRectPoint(sf::Vector2f size, float radius, Fn&& fn) {
+		const UnitArc<PointsPerCorner>& arc = unitArc<PointsPerCorner>;
+		for (unsigned int corner = 0; corner < 4; corner++) {
+			float centerX = (corner % 3 == 0) ? (size.x - radius) : radius;
+			float centerY = (corner < 2) ? (size.y - radius) : radius;
+
+			// each corner is the table turned by another quarter
+			for (unsigned int j = 0; j < PointsPerCorner; j++) {
+				float x = arc.x[j], y = arc.y[j], miterX = arc.miterX[j], miterY = arc.miterY[j];
+				switch (corner) {
+				case 1:
+					x = -arc.y[j]; y = arc.x[j]; miterX = -arc.miterY[j]; miterY = arc.miterX[j];
+					break;
+				case 2:
+					x = -arc.x[j]; y = -arc.y[j]; miterX = -arc.miterX[j]; miterY = -arc.miterY[j];
+					break;
+				case 3:
+					x = arc.y[j]; y = -arc.x[j]; miterX = arc.miterY[j]; miterY = -arc.miterX[j];
+					break;
+				}
+				fn(sf::Vector2f(centerX + radius * x, centerY + radius * y), sf::Vector2f(miterX, miterY));
+			}
+		}
+	}
+
+	/**
+	* Writes the points of a rounded rectangle
+	*
+	*   @param size - width and height of the rectangle
+	*	@param radius - radius of the corners
+	*	@param points - receives roundedRectPointCount() points
+	*/
+	template <unsigned int PointsPerCorner>
+	void roundedRectPoints(sf::Vector2f size, float radius, sf::Vector2f* points) {
+		forEachRoundedRectPoint<PointsPerCorner>(size, radius, [&points](sf::Vector2f point, sf::Vector2f) {
+			*points++ = point;
+		});
+	}
+
+	/**
+	* Writes the fill and outline of a rounded rectangle as triangles, the same ones
+	* RenderBatch produces for an equivalent sf::Shape, so many rectangles can share one
+	* vertex buffer and one draw call.
+	*
+	*   @param vertices - receives roundedRectVertexCount(outlineThickness != 0) vertices
+	*	@param transform - transform applied to every vertex
+	*	@param size - width and height of the rectangle
+	*	@param fillColor - color of the fill triangles
+	*	@param outlineThickness - thickness of the outline; 0 for none
+	*	@param outlineColor - color of the outline triangles
+	*	@param bevelAmount - radius of the corners as a fraction of the height (as in createRoundedRect())
+	*	@return number of vertices written
+	*/
+	template <unsigned int PointsPerCorner>
+	std::size_t emitRoundedRect(sf::Vertex* vertices, const sf::Transform& transform, sf::Vector2f size,
+		const sf::Color& fillColor, float outlineThickness = 0, const sf::Color& outlineColor = sf::Color::Transparent,
+		float bevelAmount = 0.2f) {
+		const std::size_t count = roundedRectPointCount<PointsPerCorner>();
+		sf::Vector2f inner[roundedRectPointCount<PointsPerCorner>()];
+		sf::Vector2f outer[roundedRectPointCount<PointsPerCorner>()];
+
+		std::size_t index = 0;
+		forEachRoundedRectPoint<PointsPerCorner>(size, size.y * bevelAmount, [&](sf::Vector2f point, sf::Vector2f miter) {
+			inner[index] = transform.transformPoint(point);
+			outer[index] = transform.transformPoint(point + miter * outlineThickness);
+			index++;
+		});
+
+		// fill: a fan around the center of the rectangle
+		sf::Vector2f center = transform.transformPoint(size.x / 2, size.y / 2);
+		sf::Vertex* out = vertices;
+		for (std::size_t i = 0; i < count; i++) {
+			*out++ = sf::Vertex(center, fillColor);
+			*out++ = sf::Vertex(inner[i], fillColor);
+			*out++ = sf::Vertex(inner[(i + 1) % count], fillColor);
+		}
+
+		// outline: the triangles of the strip inner0, outer0, inner1, outer1, ... back to the start
+		if (outlineThickness != 0) {
+			for (std::size_t i = 0; i < count; i++) {
+				std::size_t next = (i + 1) % count;
+				*out++ = sf::Vertex(inner[i], outlineColor);
+				*out++ = sf::Vertex(outer[i], outlineColor);
+				*out++ = sf::Vertex(inner[next], outlineColor);
+				*out++ = sf::Vertex(outer[i], outlineColor);
+				*out++ = sf::Vertex(inner[next], outlineColor);
+				*out++ = sf::Vertex(outer[next], outlineColor);
+			}
+		}
+
+		return static_cast<std::size_t>(out - vertices);
+	}
+
+	/**
+	* Appends a rounded rectangle's triangles to a vertex array of sf::Triangles; see emitRoundedRect()
+	*
+	*	@return number of vertices appended
+	*/
+	template <unsigned int PointsPerCorner>
+	std::size_t appendRoundedRect(sf::VertexArray& vertices, const sf::Transform& transform, sf::Vector2f size,
+		const sf::Color& fillColor, float outlineThickness = 0, const sf::Color& outlineColor = sf::Color::Transparent,
+		float bevelAmount = 0.2f) {
+		std::size_t first = vertices.getVertexCount();
+		vertices.resize(first + roundedRectVertexCount<PointsPerCorner>(outlineThickness != 0));
+		return emitRoundedRect<PointsPerCorner>(&vertices[first], transform, size, fillColor, outlineThickness, outlineColor, bevelAmount);
+	}
+
+	// ======================================================
+	// Shape
+	/**
+	* sf::Shape whose points come from the unit arc table. Unlike an sf::ConvexShape filled
+	* with setPoint(), which rebuilds its geometry after every point, it is built once per
+	* setGeometry() call, and its points live inside the object.
+	*/
+	template <unsigned int PointsPerCorner = 5>
+	class RoundedRectShape : public sf::Shape {
+
+	public:
+		/**
+		*   @param size - width and height of the rectangle
+		*	@param bevelAmount - radius of the corners as a fraction of the height
+		*/
+		explicit RoundedRectShape(sf::Vector2f size = sf::Vector2f(), float bevelAmount = 0.2f) {
+			setGeometry(size, bevelAmount);
+		}
+
+		/**
+		* Changes the size and corner radius and rebuilds the shape's geometry once
+		*/
+		void setGeometry(sf::Vector2f size, float bevelAmount) {
+			rectSize = size;
+			rectBevelAmount = bevelAmount;
+			roundedRectPoints<PointsPerCorner>(size, size.y * bevelAmount, points);
+			update();
+		}
+
+		sf::Vector2f getSize() const { return rectSize; }
+		float getBevelAmount() const { return rectBevelAmount; }
+
+		std::size_t getPointCount() const override { return roundedRectPointCount<PointsPerCorner>(); }
+		sf::Vector2f getPoint(std::size_t index) const override { return points[index]; }
+
+	private:
+		sf::Vector2f rectSize;
+		float rectBevelAmount = 0.2f;
+		sf::Vector2f points[roundedRectPointCount<PointsPerCorner>()];
+	};
+}
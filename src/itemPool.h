@@ -0,0 +1,121 @@
+/** --------------------------------------------------------
+* @file    itemPool.h
+* @author  Luke Wagner
+* @version 1.0
+*
+* ItemPool class template
+*   Allocates objects in fixed-size chunks and reuses freed slots, so objects keep a
+*	stable address for their whole life and creating/destroying them does not hit the heap
+*
+* ------------------------------------------------------------ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+template <typename T, std::size_t ChunkSize = 64>
+class ItemPool {
+
+public:
+	// ======================================================
+	// Constructors + Destructor
+	ItemPool() = default;
+	ItemPool(const ItemPool&) = delete;
+	ItemPool& operator=(const ItemPool&) = delete;
+
+	/**
+	* Destroys every object still alive in the pool and releases all chunks
+	*/
+	~ItemPool()
+	{
+		for (std::unique_ptr<Slot[]>& chunk : chunks) {
+			for (std::size_t i = 0; i < ChunkSize; i++) {
+				if (chunk[i].live) {
+					chunk[i].object()->~T();
+				}
+			}
+		}
+	}
+
+	// ======================================================
+	// Allocation
+	/**
+	* Creates a copy of an object in a free slot, adding a chunk if every slot is in use
+	*
+	*   @param prototype - the object to copy
+	*	@return pointer to the new object; stays valid until destroy() is called on it
+	*/
+	T* create(const T& prototype)
+	{
+		if (!freeList) {
+			addChunk();
+		}
+
+		Slot* slot = freeList;
+		T* obj = new (slot->storage) T(prototype);
+		freeList = slot->nextFree;
+		slot->live = true;
+		liveCount++;
+		return obj;
+	}
+
+	// ------------------------------------------------------
+	/**
+	* Destroys an object created by this pool and makes its slot available again
+	*
+	*   @param obj - the object to destroy
+	*/
+	void destroy(T* obj)
+	{
+		Slot* slot = reinterpret_cast<Slot*>(reinterpret_cast<unsigned char*>(obj) - offsetof(Slot, storage));
+		obj->~T();
+		slot->live = false;
+		slot->nextFree = freeList;
+		freeList = slot;
+		liveCount--;
+	}
+
+	// ======================================================
+	// Accessors
+	/**
+	*	@return number of objects currently alive in the pool
+	*/
+	std::size_t size() const { return liveCount; }
+
+	/**
+	*	@return number of slots allocated, alive or free
+	*/
+	std::size_t capacity() const { return chunks.size() * ChunkSize; }
+
+private:
+	// one object's worth of storage plus bookkeeping
+	struct Slot {
+		alignas(T) unsigned char storage[sizeof(T)];
+		Slot* nextFree;	//next slot in the free list while this slot is unused
+		bool live;	//true while storage holds a constructed object
+
+		T* object() { return reinterpret_cast<T*>(storage); }
+	};
+
+	std::vector<std::unique_ptr<Slot[]>> chunks;
+	Slot* freeList = nullptr;
+	std::size_t liveCount = 0;
+
+	// ------------------------------------------------------
+	// Helper Functions
+	/**
+	* Allocates a new chunk and pushes its slots onto the free list
+	*/
+	void addChunk()
+	{
+		std::unique_ptr<Slot[]> chunk(new Slot[ChunkSize]);
+		for (std::size_t i = ChunkSize; i > 0; i--) {
+			chunk[i - 1].live = false;
+			chunk[i - 1].nextFree = freeList;
+			freeList = &chunk[i - 1];
+		}
+		chunks.push_back(std::move(chunk));
+	}
+};
@@ -0,0 +1,354 @@
+/** --------------------------------------------------------
+* @file    renderBatch.cpp
+* @author  Luke Wagner
+* @version 1.0
+*
+* RenderBatch class implementation
+*   Geometry is generated the same way SFML 2.5 generates it for sf::Shape and
+*	sf::Text, so a batched draw produces the same pixels as drawing each object
+*
+* ------------------------------------------------------------ */
+#include "renderBatch.h"
+
+#include <algorithm>
+#include <cmath>
+
+void RenderBatch::clear()
+{
+	shapeVertices.clear();
+	for (TextureGroup& group : textureGroups) {
+		group.vertices.clear();
+	}
+}
+
+void RenderBatch::addShape(const sf::Shape& shape, const sf::Transform& parentTransform)
+{
+	std::size_t count = shape.getPointCount();
+	if (count < 3) {
+		return; // sf::Shape draws nothing either
+	}
+
+	sf::Transform transform = parentTransform * shape.getTransform();
+
+	// center of the shape's bounds is the hub of the fill's triangle fan
+	sf::Vector2f minPoint = shape.getPoint(0);
+	sf::Vector2f maxPoint = minPoint;
+	for (std::size_t i = 1; i < count; i++) {
+		sf::Vector2f point = shape.getPoint(i);
+		minPoint.x = std::min(minPoint.x, point.x);
+		minPoint.y = std::min(minPoint.y, point.y);
+		maxPoint.x = std::max(maxPoint.x, point.x);
+		maxPoint.y = std::max(maxPoint.y, point.y);
+	}
+	sf::Vector2f center = { minPoint.x + (maxPoint.x - minPoint.x) / 2, minPoint.y + (maxPoint.y - minPoint.y) / 2 };
+
+	// fill
+	sf::Color fillColor = shape.getFillColor();
+	sf::Vector2f transformedCenter = transform.transformPoint(center);
+	for (std::size_t i = 0; i < count; i++) {
+		shapeVertices.append(sf::Vertex(transformedCenter, fillColor));
+		shapeVertices.append(sf::Vertex(transform.transformPoint(shape.getPoint(i)), fillColor));
+		shapeVertices.append(sf::Vertex(transform.transformPoint(shape.getPoint((i + 1) % count)), fillColor));
+	}
+
+	// outline
+	float thickness = shape.getOutlineThickness();
+	if (thickness == 0) {
+		return;
+	}
+
+	auto computeNormal = [](sf::Vector2f p1, sf::Vector2f p2) {
+		sf::Vector2f normal(p1.y - p2.y, p2.x - p1.x);
+		float length = std::sqrt(normal.x * normal.x + normal.y * normal.y);
+		if (length != 0.f)
+			normal /= length;
+		return normal;
+	};
+
+	// inner and outer point of the outline at each corner, in strip order
+	sf::Color outlineColor = shape.getOutlineColor();
+	sf::Vector2f firstInner;
+	sf::Vector2f firstOuter;
+	sf::Vector2f strip[2];
+	std::size_t stripSize = 0;
+	auto pushStripVertex = [&](sf::Vector2f position) {
+		if (stripSize >= 2) {
+			shapeVertices.append(sf::Vertex(strip[0], outlineColor));
+			shapeVertices.append(sf::Vertex(strip[1], outlineColor));
+			shapeVertices.append(sf::Vertex(position, outlineColor));
+		}
+		if (stripSize < 2) {
+			strip[stripSize] = position;
+		} else {
+			strip[0] = strip[1];
+			strip[1] = position;
+		}
+		stripSize++;
+	};
+
+	for (std::size_t i = 0; i < count; i++) {
+		sf::Vector2f p0 = shape.getPoint((i + count - 1) % count);
+		sf::Vector2f p1 = shape.getPoint(i);
+		sf::Vector2f p2 = shape.getPoint((i + 1) % count);
+
+		sf::Vector2f n1 = computeNormal(p0, p1);
+		sf::Vector2f n2 = computeNormal(p1, p2);
+
+		// make sure that the normals point towards the outside of the shape
+		if (n1.x * (center.x - p1.x) + n1.y * (center.y - p1.y) > 0)
+			n1 = -n1;
+		if (n2.x * (center.x - p1.x) + n2.y * (center.y - p1.y) > 0)
+			n2 = -n2;
+
+		float factor = 1.f + (n1.x * n2.x + n1.y * n2.y);
+		sf::Vector2f normal = (n1 + n2) / factor;
+
+		sf::Vector2f inner = transform.transformPoint(p1);
+		sf::Vector2f outer = transform.transformPoint(p1 + normal * thickness);
+		if (i == 0) {
+			firstInner = inner;
+			firstOuter = outer;
+		}
+		pushStripVertex(inner);
+		pushStripVertex(outer);
+	}
+
+	// close the strip
+	pushStripVertex(firstInner);
+	pushStripVertex(firstOuter);
+}
+
+void RenderBatch::addText(const sf::Text& text, const sf::Transform& parentTransform)
+{
+	const sf::Font* font = text.getFont();
+	if (!font || text.getString().isEmpty()) {
+		return;
+	}
+
+	// outline quads go first so the fill is drawn over them, as in sf::Text
+	sf::VertexArray& vertices = getTextureVertices(&font->getTexture(text.getCharacterSize()));
+	if (text.getOutlineThickness() != 0) {
+		addTextVertices(vertices, text, parentTransform, true);
+	}
+	addTextVertices(vertices, text, parentTransform, false);
+}
+
+RenderBatch::Range RenderBatch::addVertices(const sf::VertexArray& vertices, const sf::Texture* texture,
+	const sf::Transform& transform, const sf::Shader* shader)
+{
+	Range range;
+	range.texture = texture;
+	if (vertices.getVertexCount() == 0) {
+		return range;
+	}
+
+	range.group = getTextureGroup(texture, shader);
+	sf::VertexArray& groupVertices = textureGroups[range.group].vertices;
+	range.start = groupVertices.getVertexCount();
+	range.count = vertices.getVertexCount();
+	for (std::size_t i = 0; i < vertices.getVertexCount(); i++) {
+		sf::Vertex vertex = vertices[i];
+		vertex.position = transform.transformPoint(vertex.position);
+		groupVertices.append(vertex);
+	}
+	return range;
+}
+
+void RenderBatch::patchVertices(const Range& range, const sf::VertexArray& vertices, std::size_t first, std::size_t last,
+	const sf::Transform& transform)
+{
+	sf::VertexArray& groupVertices = textureGroups[range.group].vertices;
+	for (std::size_t i = first; i < last && i < range.count; i++) {
+		sf::Vertex vertex = vertices[i];
+		vertex.position = transform.transformPoint(vertex.position);
+		groupVertices[range.start + i] = vertex;
+	}
+}
+
+void RenderBatch::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	if (shapeVertices.getVertexCount() > 0) {
+		sf::RenderStates shapeStates = states;
+		shapeStates.texture = nullptr;
+		target.draw(shapeVertices, shapeStates);
+	}
+
+	for (const TextureGroup& group : textureGroups) {
+		if (group.vertices.getVertexCount() > 0) {
+			sf::RenderStates textStates = states;
+			textStates.texture = group.texture;
+			if (group.shader)
+				textStates.shader = group.shader;
+			target.draw(group.vertices, textStates);
+		}
+	}
+}
+
+std::size_t RenderBatch::getDrawCallCount() const
+{
+	std::size_t drawCalls = shapeVertices.getVertexCount() > 0 ? 1 : 0;
+	for (const TextureGroup& group : textureGroups) {
+		if (group.vertices.getVertexCount() > 0)
+			drawCalls++;
+	}
+	return drawCalls;
+}
+
+std::size_t RenderBatch::getVertexCount() const
+{
+	std::size_t vertexCount = shapeVertices.getVertexCount();
+	for (const TextureGroup& group : textureGroups) {
+		vertexCount += group.vertices.getVertexCount();
+	}
+	return vertexCount;
+}
+
+std::size_t RenderBatch::getMemoryUsage() const
+{
+	return sizeof(RenderBatch) + textureGroups.capacity() * sizeof(TextureGroup) + getVertexCount() * sizeof(sf::Vertex);
+}
+
+sf::VertexArray& RenderBatch::getTextureVertices(const sf::Texture* texture, const sf::Shader* shader)
+{
+	return textureGroups[getTextureGroup(texture, shader)].vertices;
+}
+
+std::size_t RenderBatch::getTextureGroup(const sf::Texture* texture, const sf::Shader* shader)
+{
+	for (std::size_t i = 0; i < textureGroups.size(); i++) {
+		if (textureGroups[i].texture == texture && textureGroups[i].shader == shader) {
+			return i;
+		}
+	}
+
+	textureGroups.push_back({ texture, shader, sf::VertexArray(sf::Triangles) });
+	return textureGroups.size() - 1;
+}
+
+void RenderBatch::addGlyphQuad(sf::VertexArray& vertices, const sf::Transform& transform, sf::Vector2f position,
+	const sf::Color& color, const sf::Glyph& glyph, float italicShear, float outlineThickness)
+{
+	float padding = 1.0;
+
+	float left = glyph.bounds.left - padding;
+	float top = glyph.bounds.top - padding;
+	float right = glyph.bounds.left + glyph.bounds.width + padding;
+	float bottom = glyph.bounds.top + glyph.bounds.height + padding;
+
+	float u1 = static_cast<float>(glyph.textureRect.left) - padding;
+	float v1 = static_cast<float>(glyph.textureRect.top) - padding;
+	float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+	float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+	sf::Vector2f topLeft = transform.transformPoint(position.x + left - italicShear * top - outlineThickness, position.y + top - outlineThickness);
+	sf::Vector2f topRight = transform.transformPoint(position.x + right - italicShear * top - outlineThickness, position.y + top - outlineThickness);
+	sf::Vector2f bottomLeft = transform.transformPoint(position.x + left - italicShear * bottom - outlineThickness, position.y + bottom - outlineThickness);
+	sf::Vector2f bottomRight = transform.transformPoint(position.x + right - italicShear * bottom - outlineThickness, position.y + bottom - outlineThickness);
+
+	vertices.append(sf::Vertex(topLeft, color, sf::Vector2f(u1, v1)));
+	vertices.append(sf::Vertex(topRight, color, sf::Vector2f(u2, v1)));
+	vertices.append(sf::Vertex(bottomLeft, color, sf::Vector2f(u1, v2)));
+	vertices.append(sf::Vertex(bottomLeft, color, sf::Vector2f(u1, v2)));
+	vertices.append(sf::Vertex(topRight, color, sf::Vector2f(u2, v1)));
+	vertices.append(sf::Vertex(bottomRight, color, sf::Vector2f(u2, v2)));
+}
+
+void RenderBatch::addLine(sf::VertexArray& vertices, const sf::Transform& transform, float lineLength, float lineTop,
+	const sf::Color& color, float offset, float thickness, float outlineThickness)
+{
+	float top = std::floor(lineTop + offset - (thickness / 2) + 0.5f);
+	float bottom = top + std::floor(thickness + 0.5f);
+
+	sf::Vector2f topLeft = transform.transformPoint(-outlineThickness, top - outlineThickness);
+	sf::Vector2f topRight = transform.transformPoint(lineLength + outlineThickness, top - outlineThickness);
+	sf::Vector2f bottomLeft = transform.transformPoint(-outlineThickness, bottom + outlineThickness);
+	sf::Vector2f bottomRight = transform.transformPoint(lineLength + outlineThickness, bottom + outlineThickness);
+
+	vertices.append(sf::Vertex(topLeft, color, sf::Vector2f(1, 1)));
+	vertices.append(sf::Vertex(topRight, color, sf::Vector2f(1, 1)));
+	vertices.append(sf::Vertex(bottomLeft, color, sf::Vector2f(1, 1)));
+	vertices.append(sf::Vertex(bottomLeft, color, sf::Vector2f(1, 1)));
+	vertices.append(sf::Vertex(topRight, color, sf::Vector2f(1, 1)));
+	vertices.append(sf::Vertex(bottomRight, color, sf::Vector2f(1, 1)));
+}
+
+void RenderBatch::addTextVertices(sf::VertexArray& vertices, const sf::Text& text, const sf::Transform& parentTransform, bool outlinePass)
+{
+	const sf::Font& font = *text.getFont();
+	const sf::String& string = text.getString();
+	sf::Transform transform = parentTransform * text.getTransform();
+	unsigned int characterSize = text.getCharacterSize();
+	float outlineThickness = outlinePass ? text.getOutlineThickness() : 0;
+	const sf::Color& color = outlinePass ? text.getOutlineColor() : text.getFillColor();
+
+	// compute values related to the text style
+	sf::Uint32 style = text.getStyle();
+	bool isBold = style & sf::Text::Bold;
+	bool isUnderlined = style & sf::Text::Underlined;
+	bool isStrikeThrough = style & sf::Text::StrikeThrough;
+	float italicShear = (style & sf::Text::Italic) ? 0.209f : 0.f; // 12 degrees in radians
+	float underlineOffset = font.getUnderlinePosition(characterSize);
+	float underlineThickness = font.getUnderlineThickness(characterSize);
+
+	// location of the strike through is the center of the lowercase 'x' glyph
+	sf::FloatRect xBounds = font.getGlyph(L'x', characterSize, isBold).bounds;
+	float strikeThroughOffset = xBounds.top + xBounds.height / 2.f;
+
+	float whitespaceWidth = font.getGlyph(L' ', characterSize, isBold).advance;
+	float letterSpacing = (whitespaceWidth / 3.f) * (text.getLetterSpacing() - 1.f);
+	whitespaceWidth += letterSpacing;
+	float lineSpacing = font.getLineSpacing(characterSize) * text.getLineSpacing();
+	float x = 0.f;
+	float y = static_cast<float>(characterSize);
+
+	sf::Uint32 prevChar = 0;
+	for (std::size_t i = 0; i < string.getSize(); i++) {
+		sf::Uint32 curChar = string[i];
+
+		// skip the \r char to avoid weird graphical issues
+		if (curChar == L'\r')
+			continue;
+
+		x += font.getKerning(prevChar, curChar, characterSize);
+
+		if (curChar == L'\n' && prevChar != L'\n') {
+			if (isUnderlined)
+				addLine(vertices, transform, x, y, color, underlineOffset, underlineThickness, outlineThickness);
+			if (isStrikeThrough)
+				addLine(vertices, transform, x, y, color, strikeThroughOffset, underlineThickness, outlineThickness);
+		}
+
+		prevChar = curChar;
+
+		// whitespace only advances the pen
+		if (curChar == L' ' || curChar == L'\n' || curChar == L'\t') {
+			switch (curChar) {
+			case L' ':
+				x += whitespaceWidth;
+				break;
+			case L'\t':
+				x += whitespaceWidth * 4;
+				break;
+			case L'\n':
+				y += lineSpacing;
+				x = 0;
+				break;
+			}
+			continue;
+		}
+
+		const sf::Glyph& glyph = font.getGlyph(curChar, characterSize, isBold, outlineThickness);
+		addGlyphQuad(vertices, transform, sf::Vector2f(x, y), color, glyph, italicShear, outlineThickness);
+
+		// the pen always advances by the non-outlined glyph
+		x += (outlinePass ? font.getGlyph(curChar, characterSize, isBold).advance : glyph.advance) + letterSpacing;
+	}
+
+	// lines for the last line of text
+	if (x > 0) {
+		if (isUnderlined)
+			addLine(vertices, transform, x, y, color, underlineOffset, underlineThickness, outlineThickness);
+		if (isStrikeThrough)
+			addLine(vertices, transform, x, y, color, strikeThroughOffset, underlineThickness, outlineThickness);
+	}
+}
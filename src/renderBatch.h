@@ -0,0 +1,171 @@
+/** --------------------------------------------------------
+* @file    renderBatch.h
+* @author  Luke Wagner
+* @version 1.0
+*
+* RenderBatch class definition
+*   Collects the geometry of many SFML shapes and text objects into a few vertex
+*	arrays so they can be drawn with one draw call per texture
+*
+* ------------------------------------------------------------ */
+#pragma once
+
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "geometry.h"
+
+class RenderBatch {
+
+public:
+	// where addVertices() put a run of vertices; valid until the next clear()
+	struct Range {
+		std::size_t group = 0;	//index of the texture group
+		std::size_t start = 0;	//first vertex in the group
+		std::size_t count = 0;
+		const sf::Texture* texture = nullptr;
+	};
+
+	// ======================================================
+	// Building the batch
+	/**
+	* Removes all geometry from the batch. Keeps allocated memory so rebuilding
+	* the batch every frame does not reallocate.
+	*/
+	void clear();
+
+	// ------------------------------------------------------
+	/**
+	* Adds the fill and outline geometry of an untextured shape to the batch, with
+	* the shape's transform already applied. Produces the same triangles that
+	* sf::Shape draws as a triangle fan (fill) and a triangle strip (outline).
+	*
+	*   @param shape - the shape to add; its texture (if any) is ignored
+	*   @param parentTransform - transform applied on top of the shape's own (e.g. of the group it belongs to)
+	*/
+	void addShape(const sf::Shape& shape, const sf::Transform& parentTransform = sf::Transform::Identity);
+
+	// ------------------------------------------------------
+	/**
+	* Adds a rounded rectangle with the table-driven kernels of geometry.h instead of
+	* addShape(): the outline comes from precomputed miters, with no normals to compute.
+	* Covers the same area as addShape() would for the shape.
+	*
+	*   @param shape - the rounded rectangle to add
+	*   @param parentTransform - transform applied on top of the shape's own
+	*/
+	template <unsigned int PointsPerCorner>
+	void addRoundedRect(const geometry::RoundedRectShape<PointsPerCorner>& shape, const sf::Transform& parentTransform = sf::Transform::Identity) {
+		geometry::appendRoundedRect<PointsPerCorner>(shapeVertices, parentTransform * shape.getTransform(), shape.getSize(),
+			shape.getFillColor(), shape.getOutlineThickness(), shape.getOutlineColor(), shape.getBevelAmount());
+	}
+
+	// ------------------------------------------------------
+	/**
+	* Adds the glyph quads of a text object to the batch, with the text's transform
+	* already applied. Quads are merged with those of other text objects that use the
+	* same glyph texture (same font and character size).
+	*
+	*   @param text - the text object to add
+	*   @param parentTransform - transform applied on top of the text's own
+	*/
+	void addText(const sf::Text& text, const sf::Transform& parentTransform = sf::Transform::Identity);
+
+	// ------------------------------------------------------
+	/**
+	* Adds prebuilt textured triangles (e.g. glyph quads) to the batch, merged with the other
+	* quads that use the same texture and shader
+	*
+	*   @param vertices - the triangles to add
+	*   @param texture - the texture their texture coordinates refer to
+	*   @param transform - transform applied to every vertex
+	*   @param shader - shader to draw them with (e.g. SdfFont::getShader()); nullptr for none
+	*	@return where the vertices were put, for patchVertices()
+	*/
+	Range addVertices(const sf::VertexArray& vertices, const sf::Texture* texture, const sf::Transform& transform,
+		const sf::Shader* shader = nullptr);
+
+	// ------------------------------------------------------
+	/**
+	* Overwrites part of a run added with addVertices(), so geometry that changes a little
+	* every frame (e.g. a counter's digits) can stay in the batch instead of being added again
+	*
+	*   @param range - where the run is, as returned by addVertices()
+	*	@param vertices - the run's new vertices; same count as when it was added
+	*	@param first - index of the first vertex to copy
+	*	@param last - index one past the last vertex to copy
+	*	@param transform - transform applied to every copied vertex
+	*/
+	void patchVertices(const Range& range, const sf::VertexArray& vertices, std::size_t first, std::size_t last,
+		const sf::Transform& transform);
+
+	// ======================================================
+	// Drawing
+	/**
+	* Draws the batch: first all untextured geometry, then the glyphs of each texture.
+	*
+	*   @param target - the target to draw to
+	*   @param states - render states to combine with (transform, blend mode)
+	*/
+	void draw(sf::RenderTarget& target, sf::RenderStates states = sf::RenderStates::Default) const;
+
+	// ======================================================
+	// Accessors
+	/**
+	*	@return number of draw calls draw() issues for the current contents
+	*/
+	std::size_t getDrawCallCount() const;
+
+	/**
+	*	@return number of vertices draw() submits for the current contents
+	*/
+	std::size_t getVertexCount() const;
+
+	/**
+	*	@return approximate number of bytes of vertex data the batch holds
+	*/
+	std::size_t getMemoryUsage() const;
+
+private:
+	// glyph quads that share one font texture and shader
+	struct TextureGroup {
+		const sf::Texture* texture;
+		const sf::Shader* shader;
+		sf::VertexArray vertices;
+	};
+
+	sf::VertexArray shapeVertices = sf::VertexArray(sf::Triangles);	//untextured geometry (backgrounds, outlines)
+	std::vector<TextureGroup> textureGroups;	//kept between clear() calls so their memory is reused
+
+	// ------------------------------------------------------
+	// Helper Functions
+	/**
+	* Gets the vertex array holding quads for a texture and shader, creating it if necessary
+	*
+	*   @param texture - the glyph texture
+	*   @param shader - the shader the quads are drawn with; nullptr for none
+	*	@return reference to the vertex array for that texture
+	*/
+	sf::VertexArray& getTextureVertices(const sf::Texture* texture, const sf::Shader* shader = nullptr);
+
+	/**
+	* Gets the index in textureGroups of the group for a texture and shader, creating it if necessary
+	*/
+	std::size_t getTextureGroup(const sf::Texture* texture, const sf::Shader* shader);
+
+	/**
+	* Appends one glyph as two triangles; mirrors the quad layout used by sf::Text
+	*/
+	static void addGlyphQuad(sf::VertexArray& vertices, const sf::Transform& transform, sf::Vector2f position,
+		const sf::Color& color, const sf::Glyph& glyph, float italicShear, float outlineThickness = 0);
+
+	/**
+	* Appends one underline/strike through line as two triangles; mirrors sf::Text
+	*/
+	static void addLine(sf::VertexArray& vertices, const sf::Transform& transform, float lineLength, float lineTop,
+		const sf::Color& color, float offset, float thickness, float outlineThickness = 0);
+
+	/**
+	* Appends every glyph of a text object (either its outline or its fill) to a vertex array
+	*/
+	static void addTextVertices(sf::VertexArray& vertices, const sf::Text& text, const sf::Transform& parentTransform, bool outlinePass);
+};
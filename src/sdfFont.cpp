@@ -0,0 +1,483 @@
+/** --------------------------------------------------------
+* @file    sdfFont.cpp
+* @author  Luke Wagner
+* @version 1.0
+*
+* SdfFont class implementation
+*   Distance fields are computed with 8SSEDT (two sweeps over the glyph in each
+*	direction), text is laid out the way SFML 2.5 lays out sf::Text
+*
+* ------------------------------------------------------------ */
+#include "sdfFont.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace {
+	// GLSL 1.10 so it also runs on old drivers and software renderers (Mesa llvmpipe)
+	const char* const FRAGMENT_SHADER =
+		"#version 110\n"
+		"uniform sampler2D texture;\n"
+		"void main()\n"
+		"{\n"
+		"	float distance = texture2D(texture, gl_TexCoord[0].xy).a;\n"
+		"	float smoothing = 0.7 * fwidth(distance);\n"
+		"	float alpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);\n"
+		"	gl_FragColor = vec4(gl_Color.rgb, gl_Color.a * alpha);\n"
+		"}\n";
+
+	// offset from a pixel to the nearest seed pixel
+	struct Offset {
+		int dx;
+		int dy;
+		int lengthSquared() const { return dx * dx + dy * dy; }
+	};
+
+	const Offset NO_SEED = { 9999, 9999 };
+
+	/**
+	* Turns a grid of seed (0, 0) and NO_SEED offsets into the offset of every pixel to
+	* its nearest seed: one sweep down and one sweep up, each looking at the neighbours
+	* already visited
+	*/
+	void sweep(std::vector<Offset>& grid, int width, int height) {
+		auto compare = [&](Offset& offset, int x, int y, int stepX, int stepY) {
+			int neighbourX = x + stepX;
+			int neighbourY = y + stepY;
+			if (neighbourX < 0 || neighbourX >= width || neighbourY < 0 || neighbourY >= height) {
+				return;
+			}
+
+			Offset candidate = grid[neighbourY * width + neighbourX];
+			candidate.dx += stepX;
+			candidate.dy += stepY;
+			if (candidate.lengthSquared() < offset.lengthSquared()) {
+				offset = candidate;
+			}
+		};
+
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				Offset& offset = grid[y * width + x];
+				compare(offset, x, y, -1, 0);
+				compare(offset, x, y, 0, -1);
+				compare(offset, x, y, -1, -1);
+				compare(offset, x, y, 1, -1);
+			}
+			for (int x = width - 1; x >= 0; x--) {
+				compare(grid[y * width + x], x, y, 1, 0);
+			}
+		}
+
+		for (int y = height - 1; y >= 0; y--) {
+			for (int x = width - 1; x >= 0; x--) {
+				Offset& offset = grid[y * width + x];
+				compare(offset, x, y, 1, 0);
+				compare(offset, x, y, 0, 1);
+				compare(offset, x, y, -1, 1);
+				compare(offset, x, y, 1, 1);
+			}
+			for (int x = 0; x < width; x++) {
+				compare(grid[y * width + x], x, y, -1, 0);
+			}
+		}
+	}
+}
+
+SdfFont::SdfFont(const sf::Font& font)
+	: font(font)
+{
+}
+
+std::size_t SdfFont::prepare(const sf::String& characters, bool bold)
+{
+	// rasterize every missing glyph first, so the font's glyph page is read back once
+	std::vector<std::pair<std::uint64_t, sf::Glyph>> added;
+	bool hasPixels = false;
+	for (sf::Uint32 character : characters) {
+		std::uint64_t key = makeKey(character, bold);
+		if (glyphs.count(key)) {
+			continue;
+		}
+
+		const sf::Glyph& source = font.getGlyph(character, BASE_SIZE, bold);
+		SdfGlyph& glyph = glyphs[key];
+		glyph.advance = source.advance;
+		glyph.bounds = source.bounds;
+		added.push_back({ key, source });
+		hasPixels = hasPixels || (source.textureRect.width > 0 && source.textureRect.height > 0);
+	}
+
+	if (hasPixels) {
+		sf::Image page = font.getTexture(BASE_SIZE).copyToImage();
+		for (const auto& entry : added) {
+			if (entry.second.textureRect.width > 0 && entry.second.textureRect.height > 0) {
+				addGlyph(glyphs[entry.first], entry.second, page);
+			}
+		}
+	}
+
+	return added.size();
+}
+
+const SdfGlyph& SdfFont::getGlyph(sf::Uint32 codePoint, bool bold)
+{
+	auto found = glyphs.find(makeKey(codePoint, bold));
+	if (found != glyphs.end()) {
+		return found->second;
+	}
+
+	prepare(sf::String(codePoint), bold);
+	return glyphs[makeKey(codePoint, bold)];
+}
+
+TextMetrics SdfFont::measure(const sf::Text& text)
+{
+	TextMetrics metrics;
+	const sf::String& string = text.getString();
+	if (string.isEmpty()) {
+		return metrics;
+	}
+
+	unsigned int characterSize = text.getCharacterSize();
+	float scale = static_cast<float>(characterSize) / BASE_SIZE;
+	bool isBold = (text.getStyle() & sf::Text::Bold) != 0;
+	float italicShear = (text.getStyle() & sf::Text::Italic) ? 0.209f : 0.f; // 12 degrees in radians
+	prepare(string, isBold);
+
+	float whitespaceWidth = getGlyph(L' ', isBold).advance * scale;
+	float letterSpacing = (whitespaceWidth / 3.f) * (text.getLetterSpacing() - 1.f);
+	whitespaceWidth += letterSpacing;
+	float lineSpacing = font.getLineSpacing(characterSize) * text.getLineSpacing();
+	float x = 0.f;
+	float y = static_cast<float>(characterSize);
+
+	float minX = static_cast<float>(characterSize);
+	float minY = static_cast<float>(characterSize);
+	float maxX = 0.f;
+	float maxY = 0.f;
+
+	sf::Uint32 prevChar = 0;
+	for (std::size_t i = 0; i < string.getSize(); i++) {
+		sf::Uint32 curChar = string[i];
+
+		// sf::Text skips \r
+		if (curChar == L'\r')
+			continue;
+
+		x += font.getKerning(prevChar, curChar, characterSize);
+		prevChar = curChar;
+
+		// whitespace only moves the pen, but still counts towards the bounds
+		if (curChar == L' ' || curChar == L'\n' || curChar == L'\t') {
+			minX = std::min(minX, x);
+			minY = std::min(minY, y);
+
+			switch (curChar) {
+			case L' ':
+				x += whitespaceWidth;
+				break;
+			case L'\t':
+				x += whitespaceWidth * 4;
+				break;
+			case L'\n':
+				metrics.advance = std::max(metrics.advance, x);
+				y += lineSpacing;
+				x = 0;
+				break;
+			}
+
+			maxX = std::max(maxX, x);
+			maxY = std::max(maxY, y);
+			continue;
+		}
+
+		const SdfGlyph& glyph = getGlyph(curChar, isBold);
+		float left = glyph.bounds.left * scale;
+		float top = glyph.bounds.top * scale;
+		float right = (glyph.bounds.left + glyph.bounds.width) * scale;
+		float bottom = (glyph.bounds.top + glyph.bounds.height) * scale;
+
+		minX = std::min(minX, x + left - italicShear * bottom);
+		maxX = std::max(maxX, x + right - italicShear * top);
+		minY = std::min(minY, y + top);
+		maxY = std::max(maxY, y + bottom);
+
+		x += glyph.advance * scale + letterSpacing;
+	}
+
+	metrics.advance = std::max(metrics.advance, x);
+	metrics.bounds = sf::FloatRect(minX, minY, maxX - minX, maxY - minY);
+	return metrics;
+}
+
+void SdfFont::appendText(sf::VertexArray& vertices, const sf::Text& text, const sf::Transform& transform)
+{
+	const sf::String& string = text.getString();
+	if (string.isEmpty()) {
+		return;
+	}
+
+	unsigned int characterSize = text.getCharacterSize();
+	float scale = static_cast<float>(characterSize) / BASE_SIZE;
+	const sf::Color& color = text.getFillColor();
+
+	// compute values related to the text style
+	sf::Uint32 style = text.getStyle();
+	bool isBold = style & sf::Text::Bold;
+	bool isUnderlined = style & sf::Text::Underlined;
+	bool isStrikeThrough = style & sf::Text::StrikeThrough;
+	float italicShear = (style & sf::Text::Italic) ? 0.209f : 0.f; // 12 degrees in radians
+	float underlineOffset = font.getUnderlinePosition(characterSize);
+	float underlineThickness = font.getUnderlineThickness(characterSize);
+	prepare(string, isBold);
+	if ((isUnderlined || isStrikeThrough) && atlas.getSize().y == 0) {
+		allocate(0, 0); // creates the solid block lines sample
+	}
+
+	// location of the strike through is the center of the lowercase 'x' glyph
+	const SdfGlyph& xGlyph = getGlyph(L'x', isBold);
+	float strikeThroughOffset = (xGlyph.bounds.top + xGlyph.bounds.height / 2.f) * scale;
+
+	float whitespaceWidth = getGlyph(L' ', isBold).advance * scale;
+	float letterSpacing = (whitespaceWidth / 3.f) * (text.getLetterSpacing() - 1.f);
+	whitespaceWidth += letterSpacing;
+	float lineSpacing = font.getLineSpacing(characterSize) * text.getLineSpacing();
+	float x = 0.f;
+	float y = static_cast<float>(characterSize);
+
+	sf::Uint32 prevChar = 0;
+	for (std::size_t i = 0; i < string.getSize(); i++) {
+		sf::Uint32 curChar = string[i];
+
+		// skip the \r char to avoid weird graphical issues
+		if (curChar == L'\r')
+			continue;
+
+		x += font.getKerning(prevChar, curChar, characterSize);
+
+		if (curChar == L'\n' && prevChar != L'\n') {
+			if (isUnderlined)
+				addLine(vertices, transform, x, y, color, underlineOffset, underlineThickness);
+			if (isStrikeThrough)
+				addLine(vertices, transform, x, y, color, strikeThroughOffset, underlineThickness);
+		}
+
+		prevChar = curChar;
+
+		// whitespace only advances the pen
+		if (curChar == L' ' || curChar == L'\n' || curChar == L'\t') {
+			switch (curChar) {
+			case L' ':
+				x += whitespaceWidth;
+				break;
+			case L'\t':
+				x += whitespaceWidth * 4;
+				break;
+			case L'\n':
+				y += lineSpacing;
+				x = 0;
+				break;
+			}
+			continue;
+		}
+
+		const SdfGlyph& glyph = getGlyph(curChar, isBold);
+		addGlyphQuad(vertices, transform, sf::Vector2f(x, y), color, glyph, scale, italicShear);
+		x += glyph.advance * scale + letterSpacing;
+	}
+
+	// lines for the last line of text
+	if (x > 0) {
+		if (isUnderlined)
+			addLine(vertices, transform, x, y, color, underlineOffset, underlineThickness);
+		if (isStrikeThrough)
+			addLine(vertices, transform, x, y, color, strikeThroughOffset, underlineThickness);
+	}
+}
+
+const sf::Texture& SdfFont::getTexture() const
+{
+	return atlas;
+}
+
+const sf::Shader* SdfFont::getShader()
+{
+	static sf::Shader shader;
+	static bool loaded = [] {
+		if (!sf::Shader::isAvailable() || !shader.loadFromMemory(FRAGMENT_SHADER, sf::Shader::Fragment)) {
+			return false;
+		}
+		shader.setUniform("texture", sf::Shader::CurrentTexture);
+		return true;
+	}();
+
+	return loaded ? &shader : nullptr;
+}
+
+const sf::Font& SdfFont::getFont() const
+{
+	return font;
+}
+
+std::size_t SdfFont::getMemoryUsage() const
+{
+	// asking the font for a page it does not have yet would create one
+	sf::Vector2u atlasSize = atlas.getSize();
+	sf::Vector2u pageSize = glyphs.empty() ? sf::Vector2u() : font.getTexture(BASE_SIZE).getSize();
+	return sizeof(SdfFont) + glyphs.bucket_count() * sizeof(void*) +
+		glyphs.size() * (sizeof(std::pair<const std::uint64_t, SdfGlyph>) + sizeof(void*)) +
+		(static_cast<std::size_t>(atlasSize.x) * atlasSize.y + static_cast<std::size_t>(pageSize.x) * pageSize.y) * 4;
+}
+
+sf::IntRect SdfFont::allocate(unsigned int width, unsigned int height)
+{
+	// the atlas starts with the solid block
+	if (atlas.getSize().y == 0) {
+		shelfX = SOLID_SIZE + 1;
+		shelfY = 0;
+		shelfHeight = SOLID_SIZE;
+	}
+
+	// glyphs are kept a pixel apart so smooth sampling never blends two of them
+	if (shelfX + width + 1 > ATLAS_WIDTH) {
+		shelfY += shelfHeight + 1;
+		shelfX = 0;
+		shelfHeight = 0;
+	}
+
+	unsigned int neededHeight = shelfY + std::max(height, shelfHeight) + 1;
+	if (neededHeight > atlas.getSize().y) {
+		unsigned int newHeight = std::max(atlas.getSize().y, 128u);
+		while (newHeight < neededHeight) {
+			newHeight *= 2;
+		}
+
+		sf::Texture grown;
+		if (newHeight > sf::Texture::getMaximumSize() || !grown.create(ATLAS_WIDTH, newHeight)) {
+			std::cout << "ERROR: distance field atlas is full. (SdfFont::allocate())\n";
+			return sf::IntRect();
+		}
+
+		// new texture memory is undefined; gaps between glyphs must read as far outside
+		std::vector<sf::Uint8> blank(static_cast<std::size_t>(ATLAS_WIDTH) * newHeight * 4, 0);
+		grown.update(blank.data());
+		if (atlas.getSize().y > 0) {
+			grown.update(atlas, 0, 0);
+		} else {
+			std::vector<sf::Uint8> solid(SOLID_SIZE * SOLID_SIZE * 4, 255);
+			grown.update(solid.data(), SOLID_SIZE, SOLID_SIZE, 0, 0);
+		}
+		grown.setSmooth(true);
+		atlas.swap(grown);
+	}
+
+	sf::IntRect area(shelfX, shelfY, width, height);
+	shelfX += width + 1;
+	shelfHeight = std::max(shelfHeight, height);
+	return area;
+}
+
+void SdfFont::addGlyph(SdfGlyph& glyph, const sf::Glyph& source, const sf::Image& page)
+{
+	const int spread = static_cast<int>(SPREAD);
+	int glyphWidth = source.textureRect.width;
+	int glyphHeight = source.textureRect.height;
+	int width = glyphWidth + 2 * spread;
+	int height = glyphHeight + 2 * spread;
+
+	// seeds: pixels at least half covered are inside the glyph
+	const sf::Uint8* pagePixels = page.getPixelsPtr();
+	std::size_t pageWidth = page.getSize().x;
+	std::vector<bool> inside(static_cast<std::size_t>(width) * height, false);
+	std::vector<Offset> toInside(inside.size(), NO_SEED);
+	std::vector<Offset> toOutside(inside.size(), Offset{ 0, 0 });
+	for (int y = 0; y < glyphHeight; y++) {
+		for (int x = 0; x < glyphWidth; x++) {
+			std::size_t pageIndex = (static_cast<std::size_t>(source.textureRect.top + y) * pageWidth + source.textureRect.left + x) * 4;
+			if (pagePixels[pageIndex + 3] >= 128) {
+				std::size_t index = static_cast<std::size_t>(y + spread) * width + x + spread;
+				inside[index] = true;
+				toInside[index] = Offset{ 0, 0 };
+				toOutside[index] = NO_SEED;
+			}
+		}
+	}
+	sweep(toInside, width, height);
+	sweep(toOutside, width, height);
+
+	// 0.5 on the outline, rising to 1 SPREAD pixels inside it and falling to 0 SPREAD pixels outside
+	std::vector<sf::Uint8> pixels(inside.size() * 4, 255);
+	for (std::size_t i = 0; i < inside.size(); i++) {
+		float distance = inside[i] ? std::sqrt(static_cast<float>(toOutside[i].lengthSquared())) - 0.5f
+			: 0.5f - std::sqrt(static_cast<float>(toInside[i].lengthSquared()));
+		float value = std::min(std::max(0.5f + distance / (2.f * spread), 0.f), 1.f);
+		pixels[i * 4 + 3] = static_cast<sf::Uint8>(value * 255.f + 0.5f);
+	}
+
+	glyph.textureRect = allocate(width, height);
+	if (glyph.textureRect.width > 0) {
+		atlas.update(pixels.data(), width, height, glyph.textureRect.left, glyph.textureRect.top);
+	}
+}
+
+void SdfFont::addGlyphQuad(sf::VertexArray& vertices, const sf::Transform& transform, sf::Vector2f position,
+	const sf::Color& color, const SdfGlyph& glyph, float scale, float italicShear)
+{
+	if (glyph.textureRect.width == 0) {
+		return;
+	}
+
+	float padding = static_cast<float>(SPREAD);
+
+	float left = (glyph.bounds.left - padding) * scale;
+	float top = (glyph.bounds.top - padding) * scale;
+	float right = (glyph.bounds.left + glyph.bounds.width + padding) * scale;
+	float bottom = (glyph.bounds.top + glyph.bounds.height + padding) * scale;
+
+	float u1 = static_cast<float>(glyph.textureRect.left);
+	float v1 = static_cast<float>(glyph.textureRect.top);
+	float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width);
+	float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height);
+
+	sf::Vector2f topLeft = transform.transformPoint(position.x + left - italicShear * top, position.y + top);
+	sf::Vector2f topRight = transform.transformPoint(position.x + right - italicShear * top, position.y + top);
+	sf::Vector2f bottomLeft = transform.transformPoint(position.x + left - italicShear * bottom, position.y + bottom);
+	sf::Vector2f bottomRight = transform.transformPoint(position.x + right - italicShear * bottom, position.y + bottom);
+
+	vertices.append(sf::Vertex(topLeft, color, sf::Vector2f(u1, v1)));
+	vertices.append(sf::Vertex(topRight, color, sf::Vector2f(u2, v1)));
+	vertices.append(sf::Vertex(bottomLeft, color, sf::Vector2f(u1, v2)));
+	vertices.append(sf::Vertex(bottomLeft, color, sf::Vector2f(u1, v2)));
+	vertices.append(sf::Vertex(topRight, color, sf::Vector2f(u2, v1)));
+	vertices.append(sf::Vertex(bottomRight, color, sf::Vector2f(u2, v2)));
+}
+
+void SdfFont::addLine(sf::VertexArray& vertices, const sf::Transform& transform, float lineLength, float lineTop,
+	const sf::Color& color, float offset, float thickness)
+{
+	float top = std::floor(lineTop + offset - (thickness / 2) + 0.5f);
+	float bottom = top + std::floor(thickness + 0.5f);
+
+	sf::Vector2f topLeft = transform.transformPoint(0, top);
+	sf::Vector2f topRight = transform.transformPoint(lineLength, top);
+	sf::Vector2f bottomLeft = transform.transformPoint(0, bottom);
+	sf::Vector2f bottomRight = transform.transformPoint(lineLength, bottom);
+
+	// every vertex samples the middle of the solid block
+	sf::Vector2f solid(SOLID_SIZE / 2.f, SOLID_SIZE / 2.f);
+	vertices.append(sf::Vertex(topLeft, color, solid));
+	vertices.append(sf::Vertex(topRight, color, solid));
+	vertices.append(sf::Vertex(bottomLeft, color, solid));
+	vertices.append(sf::Vertex(bottomLeft, color, solid));
+	vertices.append(sf::Vertex(topRight, color, solid));
+	vertices.append(sf::Vertex(bottomRight, color, solid));
+}
+
+std::uint64_t SdfFont::makeKey(sf::Uint32 codePoint, bool bold)
+{
+	return static_cast<std::uint64_t>(codePoint) | (static_cast<std::uint64_t>(bold) << 32);
+}
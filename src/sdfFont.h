@@ -0,0 +1,156 @@
+/** --------------------------------------------------------
+* @file    sdfFont.h
+* @author  Luke Wagner
+* @version 1.0
+*
+* SdfFont class definition
+*   Signed distance field glyphs of one font. Each glyph is rasterized once, at
+*	BASE_SIZE, and stored in an atlas as the distance to its outline; a small
+*	fragment shader turns that back into sharp edges at any character size. Text
+*	drawn from the atlas needs no glyph page per character size, so texture memory
+*	stays the same however many sizes a menu uses, and scaled menus stay sharp.
+*
+* ------------------------------------------------------------ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <SFML/Graphics.hpp>
+#include "textMetrics.h"
+
+// glyph in the distance field atlas, measured at SdfFont::BASE_SIZE
+struct SdfGlyph {
+	float advance = 0;	//how far the pen moves after the glyph
+	sf::FloatRect bounds;	//ink bounds relative to the pen on the baseline
+	sf::IntRect textureRect;	//atlas area: the bounds plus SPREAD pixels on every side; empty for blank glyphs
+};
+
+class SdfFont {
+
+public:
+	static const unsigned int BASE_SIZE = 48;	//character size glyphs are rasterized at
+	static const unsigned int SPREAD = 6;	//how far (in pixels at BASE_SIZE) the field reaches either side of an outline
+
+	// ======================================================
+	// Constructors
+	/**
+	*   @param font - the font to draw; must outlive the SdfFont
+	*/
+	explicit SdfFont(const sf::Font& font);
+
+	SdfFont(const SdfFont&) = delete;
+	SdfFont& operator=(const SdfFont&) = delete;
+
+	// ======================================================
+	// Glyphs
+	/**
+	* Adds the glyphs of a string that are not in the atlas yet. The new glyphs are
+	* rasterized together and read back from the font with one texture copy. That copy waits
+	* for the GPU, so call this when text changes rather than while drawing a frame.
+	*
+	*   @param characters - the characters to add
+	*	@param bold - whether to add the bold glyphs
+	*	@return number of glyphs added
+	*/
+	std::size_t prepare(const sf::String& characters, bool bold);
+
+	// ------------------------------------------------------
+	/**
+	* Gets a glyph, adding it to the atlas first if necessary
+	*
+	*   @param codePoint - the character
+	*	@param bold - whether to get the bold glyph
+	*	@return the glyph, valid until the next glyph is added
+	*/
+	const SdfGlyph& getGlyph(sf::Uint32 codePoint, bool bold);
+
+	// ======================================================
+	// Text
+	/**
+	* Measures a text object as appendText() lays it out: sf::Text's layout with every
+	* glyph scaled from BASE_SIZE. Outline thickness is ignored (no outline is drawn).
+	*
+	*   @param text - the text object to measure; must use this font
+	*	@return the text's advance and ink bounds
+	*/
+	TextMetrics measure(const sf::Text& text);
+
+	// ------------------------------------------------------
+	/**
+	* Appends the glyph quads of a text object, including underlines and strike throughs,
+	* as triangles textured from the atlas. Draw them with getTexture() and getShader().
+	* Glyphs not prepare()d yet are added first, which stalls on the texture copy.
+	*
+	*   @param vertices - the array to append to
+	*	@param text - the text object; must use this font. Its own transform is not applied.
+	*	@param transform - transform applied to every vertex
+	*/
+	void appendText(sf::VertexArray& vertices, const sf::Text& text, const sf::Transform& transform = sf::Transform::Identity);
+
+	// ======================================================
+	// Drawing
+	/**
+	*	@return the atlas texture; smooth, with the distance in the alpha channel
+	*/
+	const sf::Texture& getTexture() const;
+
+	// ------------------------------------------------------
+	/**
+	* Gets the shader that draws atlas quads. It is compiled on first use and shared by every SdfFont.
+	*
+	*	@return the shader, or nullptr if the system does not support shaders or it failed to compile
+	*/
+	static const sf::Shader* getShader();
+
+	// ======================================================
+	// Accessors
+	/**
+	*	@return the font the atlas is built from
+	*/
+	const sf::Font& getFont() const;
+
+	/**
+	*	@return approximate number of bytes the atlas holds, including the font's BASE_SIZE glyph page
+	*/
+	std::size_t getMemoryUsage() const;
+
+private:
+	static const unsigned int ATLAS_WIDTH = 512;
+	static const unsigned int SOLID_SIZE = 4;	//fully inside block at the atlas origin, for underlines
+
+	const sf::Font& font;
+	std::unordered_map<std::uint64_t, SdfGlyph> glyphs;	//keyed by code point, plus 1 << 32 for bold
+	sf::Texture atlas;
+
+	// shelf packing: glyphs are placed left to right in rows as tall as their tallest glyph
+	unsigned int shelfX = 0;
+	unsigned int shelfY = 0;
+	unsigned int shelfHeight = 0;
+
+	// ------------------------------------------------------
+	// Helper Functions
+	/**
+	* Finds room for an area in the atlas, creating or growing the atlas if needed
+	*/
+	sf::IntRect allocate(unsigned int width, unsigned int height);
+
+	/**
+	* Computes the distance field of a glyph from its pixels in the font's glyph page and uploads it
+	*/
+	void addGlyph(SdfGlyph& glyph, const sf::Glyph& source, const sf::Image& page);
+
+	/**
+	* Appends one glyph as two triangles; the same layout as sf::Text, scaled from BASE_SIZE
+	*/
+	static void addGlyphQuad(sf::VertexArray& vertices, const sf::Transform& transform, sf::Vector2f position,
+		const sf::Color& color, const SdfGlyph& glyph, float scale, float italicShear);
+
+	/**
+	* Appends one underline/strike through line as two triangles sampling the solid block
+	*/
+	static void addLine(sf::VertexArray& vertices, const sf::Transform& transform, float lineLength, float lineTop,
+		const sf::Color& color, float offset, float thickness);
+
+	static std::uint64_t makeKey(sf::Uint32 codePoint, bool bold);
+};
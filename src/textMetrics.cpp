@@ -0,0 +1,177 @@
+/** --------------------------------------------------------
+* @file    textMetrics.cpp
+* @author  Luke Wagner
+* @version 1.0
+*
+* TextMetricsCache class implementation
+*   computeMetrics() follows sf::Text::ensureGeometryUpdate() in SFML 2.5, keeping only
+*	the pen position and the running min/max of the glyph bounds
+*
+* ------------------------------------------------------------ */
+#include "textMetrics.h"
+#include "fontRegistry.h"
+#include "sdfFont.h"
+
+#include <algorithm>
+#include <functional>
+
+TextMetricsCache::TextMetricsCache(std::size_t maxEntries)
+	: maxEntries(maxEntries)
+{
+}
+
+TextMetrics TextMetricsCache::measure(const sf::Text& text, SdfFont* distanceField)
+{
+	// a freed font's address may now belong to another font
+	unsigned long freed = FontRegistry::getFreedFontCount();
+	if (freed != freedFonts) {
+		entries.clear();
+		freedFonts = freed;
+	}
+
+	std::size_t hash = hashText(text, distanceField);
+	auto range = entries.equal_range(hash);
+	for (auto found = range.first; found != range.second; ++found) {
+		if (found->second.matches(text, distanceField)) {
+			return found->second.metrics;
+		}
+	}
+
+	if (entries.size() >= maxEntries) {
+		entries.clear();
+	}
+
+	TextMetrics metrics = distanceField && text.getFont() ? distanceField->measure(text) : computeMetrics(text);
+	entries.emplace(hash, Entry{ text.getString(), text.getFont(), text.getCharacterSize(), text.getStyle(),
+		text.getLetterSpacing(), text.getLineSpacing(), text.getOutlineThickness(), distanceField, metrics });
+	return metrics;
+}
+
+void TextMetricsCache::clear()
+{
+	entries.clear();
+}
+
+std::size_t TextMetricsCache::size() const
+{
+	return entries.size();
+}
+
+std::size_t TextMetricsCache::getMemoryUsage() const
+{
+	std::size_t bytes = entries.bucket_count() * sizeof(void*);
+	for (const auto& entry : entries) {
+		bytes += sizeof(entry) + sizeof(void*) + entry.second.string.getSize() * sizeof(sf::Uint32);
+	}
+	return bytes;
+}
+
+bool TextMetricsCache::Entry::matches(const sf::Text& text, const SdfFont* otherDistanceField) const
+{
+	return font == text.getFont() && characterSize == text.getCharacterSize() && style == text.getStyle() &&
+		letterSpacing == text.getLetterSpacing() && lineSpacing == text.getLineSpacing() &&
+		outlineThickness == text.getOutlineThickness() && distanceField == otherDistanceField && string == text.getString();
+}
+
+std::size_t TextMetricsCache::hashText(const sf::Text& text, const SdfFont* distanceField)
+{
+	// FNV-1a over the code points, then mix in the other fields
+	std::size_t hash = 14695981039346656037ull;
+	for (sf::Uint32 character : text.getString()) {
+		hash = (hash ^ character) * 1099511628211ull;
+	}
+
+	auto combine = [&hash](std::size_t value) {
+		hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+	};
+	combine(std::hash<const sf::Font*>()(text.getFont()));
+	combine(text.getCharacterSize());
+	combine(text.getStyle());
+	combine(std::hash<float>()(text.getLetterSpacing()));
+	combine(std::hash<float>()(text.getLineSpacing()));
+	combine(std::hash<float>()(text.getOutlineThickness()));
+	combine(std::hash<const SdfFont*>()(distanceField));
+	return hash;
+}
+
+TextMetrics TextMetricsCache::computeMetrics(const sf::Text& text)
+{
+	TextMetrics metrics;
+	const sf::Font* font = text.getFont();
+	const sf::String& string = text.getString();
+	if (!font || string.isEmpty()) {
+		return metrics;
+	}
+
+	unsigned int characterSize = text.getCharacterSize();
+	float outlineThickness = text.getOutlineThickness();
+	bool isBold = (text.getStyle() & sf::Text::Bold) != 0;
+	float italicShear = (text.getStyle() & sf::Text::Italic) ? 0.209f : 0.f; // 12 degrees in radians
+
+	float whitespaceWidth = font->getGlyph(L' ', characterSize, isBold).advance;
+	float letterSpacing = (whitespaceWidth / 3.f) * (text.getLetterSpacing() - 1.f);
+	whitespaceWidth += letterSpacing;
+	float lineSpacing = font->getLineSpacing(characterSize) * text.getLineSpacing();
+	float x = 0.f;
+	float y = static_cast<float>(characterSize);
+
+	float minX = static_cast<float>(characterSize);
+	float minY = static_cast<float>(characterSize);
+	float maxX = 0.f;
+	float maxY = 0.f;
+
+	sf::Uint32 prevChar = 0;
+	for (std::size_t i = 0; i < string.getSize(); i++) {
+		sf::Uint32 curChar = string[i];
+
+		// sf::Text skips \r
+		if (curChar == L'\r')
+			continue;
+
+		x += font->getKerning(prevChar, curChar, characterSize);
+		prevChar = curChar;
+
+		// whitespace only moves the pen, but still counts towards the bounds
+		if (curChar == L' ' || curChar == L'\n' || curChar == L'\t') {
+			minX = std::min(minX, x);
+			minY = std::min(minY, y);
+
+			switch (curChar) {
+			case L' ':
+				x += whitespaceWidth;
+				break;
+			case L'\t':
+				x += whitespaceWidth * 4;
+				break;
+			case L'\n':
+				metrics.advance = std::max(metrics.advance, x);
+				y += lineSpacing;
+				x = 0;
+				break;
+			}
+
+			maxX = std::max(maxX, x);
+			maxY = std::max(maxY, y);
+			continue;
+		}
+
+		// outlined text is bounded by the outline glyphs, plain text by the glyphs themselves
+		const sf::Glyph& glyph = font->getGlyph(curChar, characterSize, isBold);
+		const sf::Glyph& boundingGlyph = outlineThickness != 0 ? font->getGlyph(curChar, characterSize, isBold, outlineThickness) : glyph;
+		float left = boundingGlyph.bounds.left;
+		float top = boundingGlyph.bounds.top;
+		float right = boundingGlyph.bounds.left + boundingGlyph.bounds.width;
+		float bottom = boundingGlyph.bounds.top + boundingGlyph.bounds.height;
+
+		minX = std::min(minX, x + left - italicShear * bottom - outlineThickness);
+		maxX = std::max(maxX, x + right - italicShear * top - outlineThickness);
+		minY = std::min(minY, y + top - outlineThickness);
+		maxY = std::max(maxY, y + bottom - outlineThickness);
+
+		x += glyph.advance + letterSpacing;
+	}
+
+	metrics.advance = std::max(metrics.advance, x);
+	metrics.bounds = sf::FloatRect(minX, minY, maxX - minX, maxY - minY);
+	return metrics;
+}
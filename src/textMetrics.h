@@ -0,0 +1,102 @@
+/** --------------------------------------------------------
+* @file    textMetrics.h
+* @author  Luke Wagner
+* @version 1.0
+*
+* TextMetricsCache class definition
+*   Measures text straight from the font's glyph metrics and remembers the result,
+*	so layout code can ask for the size of the same string again and again without
+*	sf::Text rebuilding its glyph geometry
+*
+* ------------------------------------------------------------ */
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <SFML/Graphics.hpp>
+
+class SdfFont;
+
+// size of a piece of text
+struct TextMetrics {
+	float advance = 0;	//how far the pen moves along the longest line, including whitespace
+	sf::FloatRect bounds;	//ink bounds; the same rectangle sf::Text::getLocalBounds() returns
+};
+
+class TextMetricsCache {
+
+public:
+	// ======================================================
+	// Constructors
+	/**
+	*   @param maxEntries - number of measurements kept; the cache starts over when it is full
+	*/
+	explicit TextMetricsCache(std::size_t maxEntries = 8192);
+
+	// ======================================================
+	// Measuring
+	/**
+	* Measures a text object, or returns its measurement from the cache. Results are keyed by
+	* string, font, character size and style, plus the letter spacing, line spacing and
+	* outline thickness that also change the bounds. A lookup hashes the text in place; the
+	* string is only copied when it is measured. The cache starts over whenever FontRegistry
+	* frees a font, since another font may then be allocated at its address.
+	*
+	*   @param text - the text object to measure
+	*	@param distanceField - measures with the glyphs of this distance field font (see SdfFont::measure())
+	*		instead of the text's own font; nullptr for the font's glyphs
+	*	@return the text's advance and ink bounds; all zero if it has no font or string
+	*/
+	TextMetrics measure(const sf::Text& text, SdfFont* distanceField = nullptr);
+
+	// ------------------------------------------------------
+	/**
+	* Forgets every measurement
+	*/
+	void clear();
+
+	// ======================================================
+	// Accessors
+	/**
+	*	@return number of measurements in the cache
+	*/
+	std::size_t size() const;
+
+	/**
+	*	@return approximate number of bytes the cache holds
+	*/
+	std::size_t getMemoryUsage() const;
+
+private:
+	// everything about a text object that affects its size, and its measurement
+	struct Entry {
+		sf::String string;
+		const sf::Font* font;
+		unsigned int characterSize;
+		sf::Uint32 style;
+		float letterSpacing;
+		float lineSpacing;
+		float outlineThickness;
+		const SdfFont* distanceField;
+		TextMetrics metrics;
+
+		bool matches(const sf::Text& text, const SdfFont* distanceField) const;
+	};
+
+	std::unordered_multimap<std::size_t, Entry> entries;	//hash of the text's key fields -> entry
+	std::size_t maxEntries;	//entries is cleared when it reaches this size
+	unsigned long freedFonts = 0;	//FontRegistry::getFreedFontCount() when entries was last checked
+
+	// ------------------------------------------------------
+	// Helper Functions
+	/**
+	* Measures a text object with the same pen and bounds arithmetic sf::Text (SFML 2.5)
+	* uses to build its geometry, without building any vertices
+	*/
+	static TextMetrics computeMetrics(const sf::Text& text);
+
+	/**
+	* Hashes the fields of a text object an Entry holds, without copying its string
+	*/
+	static std::size_t hashText(const sf::Text& text, const SdfFont* distanceField);
+};
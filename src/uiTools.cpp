@@ -28,8 +28,10 @@ namespace uiTools {
 	// Text object functions
 
 	void setObjectOrigin(sf::Text& obj, const cornerType originPoint) {
-		sf::FloatRect objBounds = obj.getLocalBounds(); // get object bounds
+		setObjectOrigin(obj, originPoint, obj.getLocalBounds());
+	}
 
+	void setObjectOrigin(sf::Text& obj, const cornerType originPoint, const sf::FloatRect& objBounds) {
 		// necessary for text objs because of built in padding
 		sf::Vector2f offset = { objBounds.left, objBounds.top };
 
@@ -37,6 +37,16 @@ namespace uiTools {
 	*/
 	void setObjectOrigin(sf::Text& obj, const cornerType originPoint);
 
+	/**
+	* Same as setObjectOrigin(), but uses bounds that were already measured (e.g. cached)
+	* instead of asking the text object for them
+	*
+	*   @param obj - the object to modify
+	*	@param originPoint - which corner the origin should be set at
+	*	@param localBounds - the object's local bounds
+	*/
+	void setObjectOrigin(sf::Text& obj, const cornerType originPoint, const sf::FloatRect& localBounds);
+
 	/**
 	* Draws an outline around the UI object to the window
 	*
@@ -0,0 +1,109 @@
+/** --------------------------------------------------------
+* @file    updateQueue.h
+* @author  Luke Wagner
+* @version 1.0
+*
+* UpdateQueue class template
+*   Lock-free multi-producer, single-consumer queue. Any number of threads push
+*	values without taking a lock; one thread (the one drawing the menu) takes them
+*	all at once. Every push allocates a node with new, so producers are only as
+*	lock-free as the allocator (glibc's malloc may lock an arena). Implemented as
+*	a Treiber stack that the consumer swaps out whole, so no node is ever popped
+*	individually and the ABA problem cannot occur.
+*
+* ------------------------------------------------------------ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+template <typename T>
+class UpdateQueue {
+
+public:
+	// ======================================================
+	// Constructors + Destructor
+	UpdateQueue() = default;
+	UpdateQueue(const UpdateQueue&) = delete;
+	UpdateQueue& operator=(const UpdateQueue&) = delete;
+
+	/**
+	* Destroys every value that was pushed but never consumed
+	*/
+	~UpdateQueue()
+	{
+		deleteList(head.load(std::memory_order_acquire));
+	}
+
+	// ======================================================
+	// Producers (any thread)
+	/**
+	* Adds a value to the queue. Takes no lock besides whatever new takes to allocate the
+	* node; safe to call from any number of threads.
+	*
+	*   @param value - the value to add
+	*/
+	void push(T value)
+	{
+		Node* node = new Node{ std::move(value), head.load(std::memory_order_relaxed) };
+
+		// on failure node->next is refreshed with the current head and we retry
+		while (!head.compare_exchange_weak(node->next, node,
+			std::memory_order_release, std::memory_order_relaxed)) {
+		}
+	}
+
+	// ======================================================
+	// Consumer (one thread)
+	/**
+	* Takes every value pushed so far and passes it to a function, newest first, which
+	* makes keeping only the last write to something a matter of skipping what was seen.
+	* Values pushed while this runs are left for the next call.
+	*
+	*   @param fn - called as fn(T&) for each value
+	*	@return number of values consumed
+	*/
+	template <typename Fn>
+	std::size_t consumeNewestFirst(Fn&& fn)
+	{
+		Node* list = head.exchange(nullptr, std::memory_order_acquire);
+
+		std::size_t count = 0;
+		for (Node* node = list; node != nullptr; node = node->next) {
+			fn(node->value);
+			count++;
+		}
+
+		deleteList(list);
+		return count;
+	}
+
+	// ------------------------------------------------------
+	/**
+	*	@return true if nothing is waiting to be consumed; only a hint while producers are pushing
+	*/
+	bool empty() const { return head.load(std::memory_order_relaxed) == nullptr; }
+
+private:
+	struct Node {
+		T value;
+		Node* next;	//the value pushed before this one
+	};
+
+	std::atomic<Node*> head{ nullptr };	//most recently pushed value
+
+	// ------------------------------------------------------
+	// Helper Functions
+	/**
+	* Deletes a list of nodes the queue no longer shares with producers
+	*/
+	static void deleteList(Node* node)
+	{
+		while (node) {
+			Node* next = node->next;
+			delete node;
+			node = next;
+		}
+	}
+};